@@ -0,0 +1,273 @@
+#include "dsp_chain.h"
+#include "dsp_kernels.h"
+#include "processing_chain.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 离线批处理：用与 arp_duplex 相同的处理链，把 .pcm 文件以最快速度处理到另一个文件。
+//
+// - 输入文件 mmap 映射，按块切分后由所有核心并行处理；
+// - 有状态滤波器在每块之前多处理 GetWarmupFrames() 帧用于预热，丢弃其输出，
+//   处理链的延迟在块尾补齐并从输出中扣除，结果与从头顺序处理一致；
+// - 处理完的块交给写盘线程按偏移 pwrite，处理与写盘并行；
+// - 最后报告实时倍率（音频时长 / 墙钟时间）。
+//
+// 用法: arp_batch <输入.pcm> <输出.pcm> [采样率] [通道数] [增益] [线程数] [块秒数]
+// 输入输出均为 S16_LE 交错（与 arp_record 一致）
+
+namespace {
+
+constexpr size_t kBlockFrames = 4096;  // 处理链单次处理的帧数
+
+struct Chunk {
+    size_t index = 0;
+    size_t start = 0;    // 输出起始帧
+    size_t frames = 0;   // 输出帧数
+    std::vector<uint8_t> pcm;
+};
+
+// 有界的块队列：空闲缓冲与待写块都经过这里，限制内存占用
+class ChunkQueue {
+public:
+    void Push(std::unique_ptr<Chunk> c) {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            q_.push_back(std::move(c));
+        }
+        cv_.notify_one();
+    }
+    // 队列关闭且为空时返回 nullptr
+    std::unique_ptr<Chunk> Pop() {
+        std::unique_lock<std::mutex> lk(mu_);
+        cv_.wait(lk, [&]{ return closed_ || !q_.empty(); });
+        if (q_.empty()) return nullptr;
+        auto c = std::move(q_.front());
+        q_.pop_front();
+        return c;
+    }
+    void Close() {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            closed_ = true;
+        }
+        cv_.notify_all();
+    }
+private:
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::deque<std::unique_ptr<Chunk>> q_;
+    bool closed_ = false;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "用法: " << argv[0]
+                  << " <输入.pcm> <输出.pcm> [采样率] [通道数] [增益] [线程数] [块秒数]\n"
+                  << "示例: " << argv[0] << " in.pcm out.pcm 44100 2 1.5\n";
+        return 1;
+    }
+
+    const std::string input_file  = argv[1];
+    const std::string output_file = argv[2];
+    const int rate        = (argc > 3) ? std::stoi(argv[3]) : 44100;
+    const int ch          = (argc > 4) ? std::stoi(argv[4]) : 2;
+    const float gain      = (argc > 5) ? std::stof(argv[5]) : 1.0f;
+    int threads           = (argc > 6) ? std::stoi(argv[6]) : 0;
+    const double chunk_s  = (argc > 7) ? std::stod(argv[7]) : 10.0;
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    dsp::KernelSet kernels;
+    if (!dsp::SelectKernels(SND_PCM_FORMAT_S16_LE, ch, &kernels)) {
+        return 1;
+    }
+    const size_t frame_bytes = kernels.frame_bytes;
+
+    // ====== 映射输入 ======
+    int in_fd = open(input_file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in_fd < 0) {
+        std::cerr << "无法打开输入文件: " << input_file << "\n";
+        return 1;
+    }
+    struct stat st;
+    if (fstat(in_fd, &st) < 0) {
+        std::cerr << "无法获取输入文件大小: " << input_file << "\n";
+        close(in_fd);
+        return 1;
+    }
+    const size_t total_frames = static_cast<size_t>(st.st_size) / frame_bytes;
+    if (total_frames == 0) {
+        std::cerr << "输入文件为空\n";
+        close(in_fd);
+        return 1;
+    }
+    void* map = mmap(nullptr, total_frames * frame_bytes, PROT_READ, MAP_PRIVATE, in_fd, 0);
+    close(in_fd);
+    if (map == MAP_FAILED) {
+        std::cerr << "无法映射输入文件\n";
+        return 1;
+    }
+    // advice 是枚举值而不是位标志，分两次调用
+    madvise(map, total_frames * frame_bytes, MADV_SEQUENTIAL);
+    madvise(map, total_frames * frame_bytes, MADV_WILLNEED);
+    const uint8_t* input = static_cast<const uint8_t*>(map);
+
+    // ====== 预分配输出 ======
+    int out_fd = open(output_file.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out_fd < 0 || ftruncate(out_fd, static_cast<off_t>(total_frames * frame_bytes)) < 0) {
+        std::cerr << "无法创建输出文件: " << output_file << "\n";
+        if (out_fd >= 0) close(out_fd);
+        munmap(map, total_frames * frame_bytes);
+        return 1;
+    }
+
+    // 用一条探测链取得预热长度与延迟
+    DspChain probe;
+    BuildProcessingChain(&probe, gain);
+    if (!probe.Prepare(rate, ch, kBlockFrames)) {
+        std::cerr << "[Batch] 处理链准备失败\n";
+        close(out_fd);
+        munmap(map, total_frames * frame_bytes);
+        return 1;
+    }
+    const size_t warmup  = probe.GetWarmupFrames();
+    const size_t latency = probe.GetLatencyFrames();
+
+    const size_t chunk_frames = std::max<size_t>(kBlockFrames, static_cast<size_t>(chunk_s * rate));
+    const size_t chunk_count = (total_frames + chunk_frames - 1) / chunk_frames;
+
+    std::cout << "[Batch] " << total_frames << " 帧 (" << total_frames / static_cast<double>(rate)
+              << " 秒), " << chunk_count << " 块, " << threads << " 线程, 预热 " << warmup
+              << " 帧, 延迟 " << latency << " 帧\n";
+
+    // ====== 缓冲池与写盘线程 ======
+    ChunkQueue free_chunks, done_chunks;
+    for (int i = 0; i < threads * 2; ++i) {
+        auto c = std::make_unique<Chunk>();
+        c->pcm.resize(chunk_frames * frame_bytes);
+        free_chunks.Push(std::move(c));
+    }
+
+    std::atomic<bool> write_error(false);
+    std::thread writer([&]{
+        while (auto c = done_chunks.Pop()) {
+            const uint8_t* p = c->pcm.data();
+            size_t left = c->frames * frame_bytes;
+            off_t off = static_cast<off_t>(c->start * frame_bytes);
+            while (left > 0) {
+                ssize_t n = pwrite(out_fd, p, left, off);
+                if (n <= 0) {
+                    write_error = true;
+                    break;
+                }
+                p += n;
+                off += n;
+                left -= static_cast<size_t>(n);
+            }
+            free_chunks.Push(std::move(c));
+        }
+    });
+
+    // ====== 并行处理 ======
+    const auto t0 = std::chrono::steady_clock::now();
+    std::atomic<size_t> next_chunk(0);
+    std::atomic<bool> prepare_error(false);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&]{
+            DspChain chain;
+            BuildProcessingChain(&chain, gain);
+            if (!chain.Prepare(rate, ch, kBlockFrames)) {
+                // 未准备好的链不能处理，通知其他线程一起停止
+                prepare_error = true;
+                return;
+            }
+            std::vector<uint8_t> block(kBlockFrames * frame_bytes);
+            std::vector<float> fbuf(kBlockFrames * ch);
+
+            while (!prepare_error) {
+                const size_t idx = next_chunk.fetch_add(1);
+                if (idx >= chunk_count) break;
+                auto c = free_chunks.Pop();
+                if (!c) break;
+
+                c->index = idx;
+                c->start = idx * chunk_frames;
+                c->frames = std::min(chunk_frames, total_frames - c->start);
+
+                // 输入范围 [a, b)：提前 warmup 帧预热，末尾多处理 latency 帧补偿延迟。
+                // 输出第 k 帧对应输入第 k - latency 帧
+                const size_t a = c->start > warmup ? c->start - warmup : 0;
+                const size_t b = c->start + c->frames + latency;
+                const size_t keep_from = c->start + latency;
+
+                chain.Reset();
+                for (size_t pos = a; pos < b; pos += kBlockFrames) {
+                    const size_t n = std::min(kBlockFrames, b - pos);
+                    // 超出文件末尾的部分以静音补齐
+                    const size_t avail = pos < total_frames ? std::min(n, total_frames - pos) : 0;
+                    if (avail > 0) {
+                        std::memcpy(block.data(), input + pos * frame_bytes, avail * frame_bytes);
+                    }
+                    if (avail < n) {
+                        std::memset(block.data() + avail * frame_bytes, 0, (n - avail) * frame_bytes);
+                    }
+
+                    kernels.ToFloat(block.data(), fbuf.data(), n);
+                    chain.Process(fbuf.data(), n);
+
+                    // 只保留属于本块的输出
+                    const size_t lo = std::max(pos, keep_from);
+                    const size_t hi = pos + n;
+                    if (hi > lo) {
+                        kernels.FromFloat(fbuf.data() + (lo - pos) * ch,
+                                          c->pcm.data() + (lo - keep_from) * frame_bytes,
+                                          hi - lo);
+                    }
+                }
+                done_chunks.Push(std::move(c));
+            }
+        });
+    }
+
+    for (auto& w : workers) w.join();
+    done_chunks.Close();
+    writer.join();
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    free_chunks.Close();
+    close(out_fd);
+    munmap(map, total_frames * frame_bytes);
+
+    if (prepare_error) {
+        std::cerr << "[Batch] 处理链准备失败，输出不完整\n";
+        return 1;
+    }
+    if (write_error) {
+        std::cerr << "[Batch] 写入输出文件失败\n";
+        return 2;
+    }
+
+    const double audio_s = total_frames / static_cast<double>(rate);
+    std::cout << "[Batch] 完成: " << output_file << "\n"
+              << "[Batch] 耗时 " << elapsed << " 秒, 实时倍率 " << audio_s / elapsed << "x\n";
+    return 0;
+}
@@ -1,10 +1,10 @@
+#include <algorithm>
 #include <atomic>
-#include <condition_variable>
 #include <csignal>
 #include <cstdint>
-#include <cstring>
 #include <iostream>
-#include <mutex>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <vector>
@@ -12,6 +12,14 @@
 
 #include "alsa_capture.h"
 #include "alsa_playback.h"
+#include "dsp_chain.h"
+#include "dsp_kernels.h"
+#include "dsp_pipeline.h"
+#include "dsp_watchdog.h"
+#include "meter_tap.h"
+#include "period_pool.h"
+#include "vad.h"
+#include "processing_chain.h"
 
 // ========== 全局运行标志 ==========
 static std::atomic<bool> g_running(true);
@@ -22,101 +30,15 @@ static void signalHandler(int signum) {
     }
 }
 
-// ========== 简易线程安全环形缓冲 ==========
-class Ring {
-public:
-    explicit Ring(size_t cap) : buf_(cap), cap_(cap) {}
-    size_t sizeBytes() const {
-        std::lock_guard<std::mutex> lk(mu_);
-        return size_;
-    }
-    size_t capacity() const { return cap_; }
-
-    // 阻塞写
-    size_t writeBlocking(const uint8_t* data, size_t n) {
-        size_t written = 0;
-        while (g_running && written < n) {
-            std::unique_lock<std::mutex> lk(mu_);
-            space_cv_.wait(lk, [&]{ return !g_running || size_ < cap_; });
-            if (!g_running) break;
-
-            size_t can = std::min(n - written, cap_ - size_);
-            // 分两段写（写指针可能绕回）
-            size_t wpos = (head_ + size_) % cap_;
-            size_t tail_space = cap_ - wpos;
-            size_t first = std::min(can, tail_space);
-            std::memcpy(&buf_[wpos], data + written, first);
-            if (can > first) {
-                std::memcpy(&buf_[0], data + written + first, can - first);
-            }
-            size_ += can;
-            written += can;
-            data_cv_.notify_one();
-        }
-        return written;
-    }
-
-    // 阻塞读
-    size_t readBlocking(uint8_t* out, size_t n) {
-        size_t got = 0;
-        while (g_running && got < n) {
-            std::unique_lock<std::mutex> lk(mu_);
-            data_cv_.wait(lk, [&]{ return !g_running || size_ > 0; });
-            if (!g_running && size_ == 0) break;
-
-            size_t can = std::min(n - got, size_);
-            size_t first = std::min(can, cap_ - head_);
-            std::memcpy(out + got, &buf_[head_], first);
-            if (can > first) {
-                std::memcpy(out + got + first, &buf_[0], can - first);
-            }
-            head_ = (head_ + can) % cap_;
-            size_ -= can;
-            got += can;
-            space_cv_.notify_one();
-        }
-        return got;
-    }
-
-    // 关闭时唤醒阻塞
-    void close() {
-        std::lock_guard<std::mutex> lk(mu_);
-        data_cv_.notify_all();
-        space_cv_.notify_all();
-    }
-
-private:
-    mutable std::mutex mu_;
-    std::condition_variable data_cv_, space_cv_;
-    std::vector<uint8_t> buf_;
-    size_t cap_{0};
-    size_t head_{0};
-    size_t size_{0};
-};
-
-// ==========实时处理入口（交错 S16LE） ==========
-static std::atomic<float> g_gain{1.0f};
-inline void user_process(int16_t* samples, size_t frames, int channels) {
-    const float gain = g_gain.load(std::memory_order_relaxed);
-    if (gain == 1.0f) return;
-    const size_t n = frames * channels;
-    for (size_t i = 0; i < n; ++i) {
-        float x = samples[i] * gain;
-        if (x > 32767.f) x = 32767.f;
-        if (x < -32768.f) x = -32768.f;
-        samples[i] = static_cast<int16_t>(x);
-    }
-}
-
-// ========== 预充辅助：等待环形缓冲达到某个水位 ==========
-bool wait_prefill(Ring& ring, size_t target_bytes, int timeout_ms) {
+// ========== 预充辅助：等待队列中积压到一定块数 ==========
+bool wait_prefill(const PeriodQueue& queue, size_t target_blocks, int timeout_ms) {
     using namespace std::chrono;
     auto deadline = steady_clock::now() + milliseconds(timeout_ms);
     while (g_running && steady_clock::now() < deadline) {
-        if (ring.sizeBytes() >= target_bytes) return true;
+        if (queue.SizeApprox() >= target_blocks || queue.IsClosed()) return true;
         std::this_thread::sleep_for(milliseconds(5));
     }
-    return ring.sizeBytes() >= target_bytes;
+    return queue.SizeApprox() >= target_blocks;
 }
 
 // ========== 主函数 ==========
@@ -124,8 +46,9 @@ int main(int argc, char* argv[]) {
     std::signal(SIGINT, signalHandler);
 
     if (argc < 5) {
-        std::cerr << "用法: " << argv[0] << " <cap_dev> <play_dev> <rate> <ch>\n"
-                  << "示例: " << argv[0] << " hw:0 hw:0 44100 2\n";
+        std::cerr << "用法: " << argv[0] << " <cap_dev> <play_dev> <rate> <ch> [流水线级数] [绑定CPU列表]\n"
+                  << "示例: " << argv[0] << " hw:0 hw:0 44100 2\n"
+                  << "      " << argv[0] << " hw:0 hw:0 44100 2 2 2,3   # 处理链分两级，分别绑定 CPU 2、3\n";
         return 1;
     }
 
@@ -133,6 +56,13 @@ int main(int argc, char* argv[]) {
     const std::string play_dev = argv[2];
     const int rate = std::stoi(argv[3]);
     const int ch   = std::stoi(argv[4]);
+    const int pipeline_stages = (argc > 5) ? std::stoi(argv[5]) : 0;  // 0 = 在播放线程内处理
+    std::vector<int> pipeline_cpus;
+    if (argc > 6) {
+        std::stringstream ss(argv[6]);
+        std::string item;
+        while (std::getline(ss, item, ',')) pipeline_cpus.push_back(std::stoi(item));
+    }
 
     std::cout << "[Main] Capture dev:  " << cap_dev  << "\n"
               << "[Main] Playback dev: " << play_dev << "\n"
@@ -150,24 +80,92 @@ int main(int argc, char* argv[]) {
     // 使用 S16LE（与你现有实现一致）
     // 如果需要改格式：playback.SetFormat(SND_PCM_FORMAT_S16_LE);
 
-    const int bytes_per_sample = 2;                 // S16LE
-    const int frame_bytes      = bytes_per_sample * ch;
+    // 按实际格式与通道数一次性选定处理内核，热路径不再判断格式
+    dsp::KernelSet kernels;
+    if (!dsp::SelectKernels(playback.GetFormat(), ch, &kernels)) {
+        std::cerr << "不支持的处理格式\n"; return 4;
+    }
+    std::cout << "[Main] DSP kernels:  " << (kernels.specialized ? "specialized" : "generic")
+              << " (" << kernels.frame_bytes << " bytes/frame)\n";
+
+    const int frame_bytes = static_cast<int>(kernels.frame_bytes);
+
+    // 处理链（与 arp_batch 离线处理共用同一定义）
+    const size_t chunk_frames = capture.GetPeriodSize(); // 采集/播放块大小 = 协商得到的采集周期
+    DspChain chain;
+    const ProcessingChainHandles handles = BuildProcessingChain(&chain, 1.0f);
+    GainNode* gain_node = handles.gain;
+    PluginNode* plugin = handles.plugin;
+
+    // 输出电平表：挂在链尾，只读不改音频；分析在独立的非实时线程中进行
+    auto meter_node = std::make_unique<MeterTap>();
+    MeterTap* meter = meter_node.get();
+    chain.AddNode(std::move(meter_node));
+
+    // CPU 预算看门狗：处理超出周期预算时逐级降低质量，宁可损失音质也不要断音
+    DspLoadWatchdog watchdog(rate);
+    RegisterDegradationLevels(&chain, &watchdog);
+
+    // 静音检测：整块静音时跳过处理、直接输出静音（控制线程输入 vad on/off 切换，默认关闭）
+    VoiceActivityDetector vad(rate, ch);
+    std::atomic<bool> vad_enabled{false};
+
+    // 可选：把处理链切成多级流水线，每级一个绑核的实时线程，
+    // 以额外的若干周期延迟换取多核吞吐量
+    std::unique_ptr<DspPipeline> pipeline;
+    if (pipeline_stages > 0) {
+        pipeline = std::make_unique<DspPipeline>(pipeline_stages);
+        if (!pipeline->Partition(&chain) ||
+            !pipeline->Prepare(kernels, rate, ch, chunk_frames) ||
+            !pipeline->Start(pipeline_cpus)) {
+            std::cerr << "处理流水线启动失败\n"; return 4;
+        }
+        std::cout << "[Main] DSP pipeline: " << pipeline->GetStageCount() << " 级, 额外延迟 "
+                  << pipeline->GetLatencyPeriods() << " 周期 ("
+                  << pipeline->GetLatencyFrames() * 1000.0 / rate << " ms)\n";
+    } else if (!chain.Prepare(rate, ch, chunk_frames)) {
+        std::cerr << "处理链准备失败\n"; return 4;
+    }
+
+    if (!meter->Start()) {
+        std::cerr << "电平表启动失败\n"; return 4;
+    }
+
+    // 处理节点引入的延迟（限幅器前瞻等），供外部做时间对齐
+    size_t node_latency = chain.GetLatencyFrames();
+    if (pipeline) {
+        for (size_t i = 0; i < pipeline->GetStageCount(); ++i) {
+            node_latency += pipeline->GetStage(i)->GetLatencyFrames();
+        }
+    }
+    std::cout << "[Main] DSP latency:  " << node_latency << " 帧 ("
+              << node_latency * 1000.0 / rate << " ms)\n";
 
-    // 环形缓冲容量：建议 500ms
-    const int ring_ms = 500;
-    const size_t ring_capacity_bytes = static_cast<size_t>(rate) * frame_bytes * ring_ms / 1000;
-    Ring ring(ring_capacity_bytes);
-    std::cout << "[Main] Ring capacity: " << ring.capacity() << " bytes (~"
-              << ring_ms << " ms)\n";
+    // 周期块池：采集线程把 ReadFrame 直接读进块，处理与播放就地使用同一块，用完归还，
+    // 稳态下不分配、不拷贝。块数覆盖约 500ms 的排队深度，外加采集与播放线程手中各一块
+    const int queue_ms = 500;
+    const size_t queue_blocks = std::max<size_t>(2, static_cast<size_t>(rate) * queue_ms / 1000 / chunk_frames);
+    PeriodPool pool;
+    if (!pool.Init(chunk_frames, frame_bytes, queue_blocks + 2)) {
+        std::cerr << "周期块池分配失败\n"; return 4;
+    }
+    PeriodQueue filled(&pool, pool.GetBlockCount());
+    std::cout << "[Main] Block pool:   " << pool.GetBlockCount() << " x " << pool.GetBlockBytes()
+              << " bytes (~" << queue_ms << " ms)\n";
+    // 预充水位：1/2 深度（或 150ms，取小者）
+    const size_t prefill_blocks = std::max<size_t>(1, std::min(queue_blocks / 2,
+        static_cast<size_t>(rate) * 150 / 1000 / chunk_frames));
 
-    // ====== 采集线程：读 ALSA → 写 ring ======
+    // ====== 采集线程：取空闲块 → 读 ALSA 直接进块 → 交给播放线程 ======
     std::thread th_cap([&]{
-        const size_t chunk_frames = 1024; // 采集块大小
-        std::vector<uint8_t> buf(chunk_frames * frame_bytes);
+        // 块池耗尽（播放端积压）时读进这里并丢弃本周期，绝不阻塞采集
+        std::vector<uint8_t> scratch(pool.GetBlockBytes());
         int frames_read = 0;
 
         while (g_running) {
-            bool ok = capture.ReadFrame(buf.data(), buf.size(), &frames_read);
+            PeriodPool::Block block = pool.Acquire();
+            uint8_t* dst = block.valid() ? block.data() : scratch.data();
+            bool ok = capture.ReadFrame(dst, pool.GetBlockBytes(), &frames_read);
             if (!ok || frames_read <= 0) {
                 // 尝试恢复
                 if (!capture.Recover()) {
@@ -176,37 +174,46 @@ int main(int argc, char* argv[]) {
                 }
                 continue;
             }
-            const size_t bytes = static_cast<size_t>(frames_read) * frame_bytes;
-            ring.writeBlocking(buf.data(), bytes);
+            if (!block.valid()) continue;
+            block.set_frames(static_cast<size_t>(frames_read));
+            filled.Push(&block);
         }
-        ring.close();
+        filled.Close();
     });
 
-    // ====== 播放线程：从 ring 取 → 处理 → 写 ALSA ======
+    // ====== 播放线程：取块 → 就地处理 → 写 ALSA → 归还块 ======
     std::thread th_play([&]{
-        const size_t chunk_frames = 1024; // 播放块大小
-        std::vector<uint8_t> buf(chunk_frames * frame_bytes);
-
-        // 启动前预充：至少 1/2 容量（或 150ms，取小者）
-        const size_t prefill_target = std::min(ring.capacity() / 2,
-            static_cast<size_t>(rate) * frame_bytes * 150 / 1000);
-        if (!wait_prefill(ring, prefill_target, /*timeout_ms*/2000)) {
+        // 启动前预充
+        if (!wait_prefill(filled, prefill_blocks, /*timeout_ms*/2000)) {
             std::cerr << "[Playback] 预充超时，仍继续尝试播放\n";
         }
 
+        PeriodPool::Block block;
         int frames_written = 0;
         while (g_running) {
-            size_t got = ring.readBlocking(buf.data(), buf.size());
-            if (got == 0) {
-                // 环形缓冲已关闭且无数据
+            if (!filled.Pop(&block)) {
+                // 队列已关闭且无数据
                 break;
             }
+            uint8_t* buf = block.data();
 
-            // 实时处理（就地）—— S16 交错
-            user_process(reinterpret_cast<int16_t*>(buf.data()),
-                         got / frame_bytes, ch);
+            // 实时处理（就地），并计入 CPU 预算
+            size_t frames = block.frames();
+            const bool active = !vad_enabled.load(std::memory_order_relaxed) ||
+                                vad.ProcessInterleaved(kernels, buf, frames);
+            if (pipeline) {
+                // 流水线：送入本周期、取回若干周期前的结果；负载取最忙一级
+                frames = pipeline->Process(buf, frames, active);
+                if (frames == 0) break;  // 流水线已停止
+                watchdog.Update(pipeline->GetMaxStageLastLoad());
+            } else {
+                watchdog.BeginPeriod();
+                chain.ProcessInterleaved(kernels, buf, frames, active);
+                watchdog.EndPeriod(frames);
+            }
 
-            bool ok = playback.WriteFrame(buf.data(), got, &frames_written);
+            bool ok = playback.WriteFrame(buf, frames * frame_bytes, &frames_written);
+            block.Release();
             if (!ok || frames_written <= 0) {
                 std::cerr << "写入音频帧失败: Broken pipe\n";
                 std::cerr << "[Playback] Write failed, trying recover\n";
@@ -215,9 +222,7 @@ int main(int argc, char* argv[]) {
                     break;
                 }
                 // ====== 恢复成功后：再次预充，防止立刻再次underrun ======
-                const size_t refill_target = std::min(ring.capacity() / 2,
-                    static_cast<size_t>(rate) * frame_bytes * 150 / 1000);
-                wait_prefill(ring, refill_target, /*timeout_ms*/2000);
+                wait_prefill(filled, prefill_blocks, /*timeout_ms*/2000);
                 continue; // 重新取下一块写
             }
         }
@@ -225,12 +230,80 @@ int main(int argc, char* argv[]) {
 
     // ====== 控制线程：动态改增益（可选） ======
     std::thread th_ctl([&]{
-    std::cout << "[Control] 输入增益 (如 0.5, 1.0, 2.0)，Ctrl+C 再按一次回车退出。\n";
+    std::cout << "[Control] 输入增益 (如 0.5, 1.0, 2.0)，输入 load 查看处理负载，meter 查看输出电平，vad on/off 切换静音跳过，plugin <路径> [配置] / plugin off 热替换插件，Ctrl+C 再按一次回车退出。\n";
     std::string line;
     while (g_running && std::getline(std::cin, line)) {
+        if (line == "load") {
+            const int level = watchdog.GetLevel();
+            std::cout << "[Control] DSP 负载 " << watchdog.GetLoad() * 100.0 << "% (峰值 "
+                      << watchdog.GetPeakLoad() * 100.0 << "%), 超时 " << watchdog.GetOverruns()
+                      << " 次, 降级 " << level << "/" << watchdog.GetLevelCount();
+            if (level > 0) {
+                std::cout << " [" << watchdog.GetLevelName(level - 1) << "]";
+            }
+            std::cout << "\n";
+            if (pipeline) {
+                for (size_t i = 0; i < pipeline->GetStageCount(); ++i) {
+                    std::cout << "[Control]   第 " << i << " 级负载 " << pipeline->GetStageLoad(i) * 100.0
+                              << "% (峰值 " << pipeline->GetStagePeakLoad(i) * 100.0 << "%)\n";
+                }
+                std::cout << "[Control]   等待输出 " << pipeline->GetStalls() << " 次\n";
+            }
+            if (vad_enabled.load(std::memory_order_relaxed) && vad.GetTotalFrames() > 0) {
+                std::cout << "[Control]   VAD 活动 " << vad.GetActiveFrames() * 100.0 / vad.GetTotalFrames()
+                          << "%（其余块跳过处理）\n";
+            }
+            continue;
+        }
+        if (line == "plugin") {
+            const std::string name = plugin->GetActiveName();
+            std::cout << "[Control] 插件: " << (name.empty() ? "(直通)" : name) << ", 已切换 "
+                      << plugin->GetSwapCount() << " 次";
+            const std::string error = plugin->GetLastError();
+            if (!error.empty()) std::cout << ", 最近错误: " << error;
+            std::cout << "\n";
+            continue;
+        }
+        if (line.compare(0, 7, "plugin ") == 0) {
+            // plugin off | plugin <路径> [配置字符串]
+            std::istringstream args(line.substr(7));
+            std::string path, config;
+            args >> path;
+            std::getline(args >> std::ws, config);
+            const bool ok = (path == "off") ? plugin->Unload() : plugin->Load(path, config);
+            std::cout << "[Control] " << (ok ? "已提交，后台准备后在周期边界切换" : "提交失败") << "\n";
+            continue;
+        }
+        if (line == "vad on" || line == "vad off") {
+            vad_enabled.store(line == "vad on", std::memory_order_relaxed);
+            std::cout << "[Control] 静音跳过 " << (line == "vad on" ? "开启" : "关闭") << "\n";
+            continue;
+        }
+        if (line == "meter") {
+            MeterSnapshot snap;
+            if (!meter->ReadSnapshot(&snap)) {
+                std::cout << "[Control] 电平表暂无数据\n";
+                continue;
+            }
+            std::cout << "[Control] 响度 M " << snap.momentary_lufs << " LUFS, S "
+                      << snap.short_term_lufs << " LUFS, 丢弃 " << snap.dropped_blocks << " 块\n";
+            for (size_t c = 0; c < snap.channels.size(); ++c) {
+                // 频谱中能量最大的频点（跳过直流）
+                const float* spectrum = snap.spectrum_db.data() + c * snap.bins;
+                size_t dominant = 1;
+                for (size_t k = 2; k < snap.bins; ++k) {
+                    if (spectrum[k] > spectrum[dominant]) dominant = k;
+                }
+                const MeterSnapshot::Channel& m = snap.channels[c];
+                std::cout << "[Control]   ch" << c << " 峰值 " << m.peak_db << " dBFS, RMS "
+                          << m.rms_db << " dBFS, TP " << m.true_peak_db << " dBTP, 主频 "
+                          << dominant * snap.bin_hz << " Hz (" << spectrum[dominant] << " dB)\n";
+            }
+            continue;
+        }
         try {
             float g = std::stof(line);          // 解析为浮点
-            g_gain.store(g);
+            gain_node->SetGain(g);
             std::cout << "[Control] gain=" << g << "\n";
         } catch (...) {                          // 非数字：忽略本次输入
             std::cout << "[Control] 非数字输入，已忽略。\n";
@@ -241,10 +314,20 @@ int main(int argc, char* argv[]) {
 
     th_ctl.join();
     g_running = false;
-    ring.close();
+    filled.Close();
     th_cap.join();
+    if (pipeline) pipeline->Stop();  // 唤醒可能阻塞在流水线中的播放线程
     th_play.join();
     if(th_ctl.joinable()) th_ctl.join();
+    meter->Stop();
+
+    if (pool.GetExhaustedCount() > 0) {
+        std::cout << "[Main] 播放积压丢弃 " << pool.GetExhaustedCount() << " 个采集周期\n";
+    }
+    if (watchdog.GetDegradeCount() > 0) {
+        std::cout << "[Main] DSP 过载降级 " << watchdog.GetDegradeCount() << " 次, 处理超时 "
+                  << watchdog.GetOverruns() << " 次\n";
+    }
 
     playback.Close();
     capture.Close();
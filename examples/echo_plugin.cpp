@@ -0,0 +1,107 @@
+#include "arp_plugin.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <new>
+#include <vector>
+
+// 示例插件：反馈回声。只依赖 arp_plugin.h，编译为独立的共享库（libarp_echo.so）。
+//
+// 配置字符串（可省略任意项）："delay_ms=250 feedback=0.4 mix=0.3"
+// 延迟线在 prepare 中按最大 2 秒一次性分配，process 中不再分配。
+
+namespace {
+
+struct Echo {
+    double delay_ms = 250.0;
+    float feedback = 0.4f;
+    float mix = 0.3f;
+
+    int channels = 0;
+    size_t delay_frames = 0;
+    std::vector<float> line;  // [delay_frames][channels]
+    size_t pos = 0;
+};
+
+void* Create(const char* config) {
+    Echo* echo = new (std::nothrow) Echo();
+    if (!echo) return nullptr;
+    // 逐项解析 key=value，未知项忽略
+    const char* p = config ? config : "";
+    while (*p) {
+        double value = 0.0;
+        int consumed = 0;
+        if (std::sscanf(p, " delay_ms=%lf%n", &value, &consumed) == 1) {
+            echo->delay_ms = value;
+        } else if (std::sscanf(p, " feedback=%lf%n", &value, &consumed) == 1) {
+            echo->feedback = static_cast<float>(value);
+        } else if (std::sscanf(p, " mix=%lf%n", &value, &consumed) == 1) {
+            echo->mix = static_cast<float>(value);
+        } else {
+            // 跳过当前这一项
+            while (*p && *p != ' ') ++p;
+            while (*p == ' ') ++p;
+            continue;
+        }
+        p += consumed;
+    }
+    echo->delay_ms = std::min(std::max(echo->delay_ms, 1.0), 2000.0);
+    echo->feedback = std::min(std::max(echo->feedback, 0.0f), 0.95f);
+    echo->mix = std::min(std::max(echo->mix, 0.0f), 1.0f);
+    return echo;
+}
+
+int Prepare(void* instance, int sample_rate, int channels, uint32_t /*max_frames*/) {
+    Echo* echo = static_cast<Echo*>(instance);
+    echo->channels = channels;
+    echo->delay_frames = std::max<size_t>(1, static_cast<size_t>(echo->delay_ms * sample_rate / 1000.0));
+    try {
+        echo->line.assign(echo->delay_frames * channels, 0.0f);
+    } catch (const std::bad_alloc&) {
+        return -1;
+    }
+    echo->pos = 0;
+    return 0;
+}
+
+void Process(void* instance, float* samples, uint32_t frames) {
+    Echo* echo = static_cast<Echo*>(instance);
+    const int ch = echo->channels;
+    for (uint32_t f = 0; f < frames; ++f) {
+        float* x = samples + static_cast<size_t>(f) * ch;
+        float* d = echo->line.data() + echo->pos * ch;
+        for (int c = 0; c < ch; ++c) {
+            const float delayed = d[c];
+            d[c] = x[c] + echo->feedback * delayed;
+            x[c] += echo->mix * delayed;
+        }
+        if (++echo->pos == echo->delay_frames) echo->pos = 0;
+    }
+}
+
+void Reset(void* instance) {
+    Echo* echo = static_cast<Echo*>(instance);
+    std::fill(echo->line.begin(), echo->line.end(), 0.0f);
+    echo->pos = 0;
+}
+
+void Destroy(void* instance) {
+    delete static_cast<Echo*>(instance);
+}
+
+const arp_plugin_descriptor kDescriptor = {
+    ARP_PLUGIN_API_VERSION,
+    "echo",
+    Create,
+    Prepare,
+    Process,
+    Reset,
+    Destroy,
+};
+
+}  // namespace
+
+extern "C" __attribute__((visibility("default")))
+const arp_plugin_descriptor* arp_plugin_entry(void) {
+    return &kDescriptor;
+}
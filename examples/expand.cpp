@@ -0,0 +1,58 @@
+#include "gated_pcm.h"
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 把 arp_record 的间隙压缩录音（.gpcm）还原为原始交错 PCM：
+// 活动通道的样本逐字节还原，静音通道与间隙填入静音值，输出与录制时的时间轴逐帧对齐。
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "用法: " << argv[0] << " <input.gpcm> <output.pcm>\n";
+        return 1;
+    }
+    const std::string input = argv[1];
+    const std::string output = argv[2];
+
+    GatedPcmReader reader;
+    if (!reader.Open(input)) {
+        return 1;
+    }
+    std::ofstream out(output, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "无法创建输出文件: " << output << std::endl;
+        return 1;
+    }
+
+    std::cout << "[Expand] " << input << ": " << reader.GetSampleRate() << " Hz, "
+              << reader.GetChannels() << " ch, " << snd_pcm_format_name(reader.GetFormat()) << "\n";
+
+    const size_t chunk_frames = 4096;
+    const size_t frame_bytes = static_cast<size_t>(reader.GetChannels()) * reader.GetBytesPerSample();
+    std::vector<uint8_t> buf(chunk_frames * frame_bytes);
+    uint64_t total = 0;
+    size_t frames = 0;
+    bool ok = true;
+    while ((ok = reader.Read(buf.data(), chunk_frames, &frames)) && frames > 0) {
+        out.write(reinterpret_cast<const char*>(buf.data()), frames * frame_bytes);
+        if (!out) {
+            std::cerr << "写入失败: " << output << std::endl;
+            return 2;
+        }
+        total += frames;
+    }
+    if (!ok) {
+        std::cerr << "[Expand] 输入文件损坏，已还原 " << total << " 帧\n";
+        return 2;
+    }
+    if (reader.GetTotalFrames() != 0 && reader.GetTotalFrames() != total) {
+        std::cerr << "[Expand] 帧数与文件头不符: " << total << " / " << reader.GetTotalFrames() << "\n";
+        return 2;
+    }
+
+    std::cout << "[Expand] 还原 " << total << " 帧 ("
+              << static_cast<double>(total) / reader.GetSampleRate() << " s) -> " << output << "\n";
+    return 0;
+}
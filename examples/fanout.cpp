@@ -0,0 +1,130 @@
+#include "alsa_capture.h"
+#include "period_broadcast.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// 一路采集同时喂给录音与电平监视两个消费者，周期数据零拷贝共享
+
+static std::atomic<bool> g_running(true);
+static void signalHandler(int signum) {
+    if (signum == SIGINT) {
+        std::cout << "\n[Signal] Ctrl+C\n";
+        g_running = false;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::signal(SIGINT, signalHandler);
+
+    const std::string device      = (argc > 1) ? argv[1] : "hw:0";
+    const std::string output_file = (argc > 2) ? argv[2] : "recording.pcm";
+    const int rate = 44100;
+    const int ch   = 2;
+
+    AlsaCapture capture(device, rate, ch);
+    if (!capture.Open()) {
+        std::cerr << "Capture 打开失败\n";
+        return 1;
+    }
+
+    const size_t frame_bytes  = static_cast<size_t>(ch) * capture.GetBytesPerSample();
+    const size_t period_bytes = capture.GetPeriodSize() * frame_bytes;
+
+    // 保留约 32 个周期的历史，最多 4 个读者
+    PeriodBroadcast broadcast(period_bytes, 32, 4);
+
+    // ====== 消费者 1：录音（允许短暂落后，追不上就跳过） ======
+    const int rec_reader = broadcast.AddReader(PeriodBroadcast::SlowReaderPolicy::kSkipForward);
+    std::thread th_rec([&]{
+        std::ofstream outfile(output_file, std::ios::binary);
+        if (!outfile.is_open()) {
+            std::cerr << "[Record] 无法创建输出文件: " << output_file << "\n";
+            return;
+        }
+        PeriodBroadcast::Block block;
+        while (true) {
+            auto st = broadcast.Read(rec_reader, &block, 500);
+            if (st == PeriodBroadcast::ReadStatus::kClosed ||
+                st == PeriodBroadcast::ReadStatus::kDropped) {
+                break;
+            }
+            if (!block.valid()) continue;
+            if (st == PeriodBroadcast::ReadStatus::kSkipped) {
+                std::cerr << "[Record] 落后，累计跳过 "
+                          << broadcast.GetSkippedPeriods(rec_reader) << " 个周期\n";
+            }
+            outfile.write(reinterpret_cast<const char*>(block.data()), block.bytes());
+        }
+        std::cout << "[Record] 已保存: " << output_file << "\n";
+    });
+
+    // ====== 消费者 2：电平监视（只关心最新数据） ======
+    const int meter_reader = broadcast.AddReader(PeriodBroadcast::SlowReaderPolicy::kSkipForward);
+    std::thread th_meter([&]{
+        PeriodBroadcast::Block block;
+        int peak = 0;
+        size_t frames = 0;
+        while (true) {
+            auto st = broadcast.Read(meter_reader, &block, 500);
+            if (st == PeriodBroadcast::ReadStatus::kClosed ||
+                st == PeriodBroadcast::ReadStatus::kDropped) {
+                break;
+            }
+            if (!block.valid()) continue;
+            // 采集格式为 S16 交错
+            const int16_t* s = reinterpret_cast<const int16_t*>(block.data());
+            const size_t n = block.bytes() / sizeof(int16_t);
+            for (size_t i = 0; i < n; ++i) {
+                const int v = std::abs(static_cast<int>(s[i]));
+                if (v > peak) peak = v;
+            }
+            frames += block.frames();
+            if (frames >= static_cast<size_t>(rate)) {
+                const double dbfs = peak > 0 ? 20.0 * std::log10(peak / 32768.0) : -120.0;
+                std::cout << "[Meter] peak " << dbfs << " dBFS\n";
+                peak = 0;
+                frames = 0;
+            }
+        }
+    });
+
+    // ====== 采集线程（主线程）：直接读进广播块，无额外拷贝 ======
+    std::cout << "开始采集，按Ctrl+C停止..." << std::endl;
+    int frames_read = 0;
+    while (g_running) {
+        uint8_t* dst = broadcast.BeginWrite();
+        if (!dst) {
+            // 块池被读者占满：丢弃本周期，采集线程不等待
+            static uint8_t scratch[65536];
+            capture.ReadFrame(scratch, std::min(sizeof(scratch), period_bytes), &frames_read);
+            continue;
+        }
+        if (!capture.ReadFrame(dst, period_bytes, &frames_read) || frames_read <= 0) {
+            broadcast.AbortWrite();
+            if (!capture.Recover()) {
+                std::cerr << "[Capture] 读取失败，恢复失败，退出\n";
+                break;
+            }
+            continue;
+        }
+        broadcast.CommitWrite(frames_read, static_cast<size_t>(frames_read) * frame_bytes);
+    }
+
+    broadcast.Close();
+    th_rec.join();
+    th_meter.join();
+    std::cout << "[Main] 丢弃周期: " << broadcast.GetDroppedWrites() << "\n";
+
+    capture.Close();
+    std::cout << "[Main] 退出\n";
+    return 0;
+}
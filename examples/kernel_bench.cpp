@@ -0,0 +1,145 @@
+#include "dsp_kernels.h"
+#include "limiter_node.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// 处理内核基准：通用版本（运行期通道数）与编译期特化版本的对比，
+// 以及限幅器在 48kHz 下占用单核的比例。无需音频硬件。
+//
+// 用法: arp_kernel_bench [每块帧数] [迭代次数]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Timing {
+    double gain_ns;     // 每帧耗时
+    double convert_ns;  // ToFloat + FromFloat 往返每帧耗时
+};
+
+Timing Run(const dsp::KernelSet& k, std::vector<uint8_t>& pcm, std::vector<float>& tmp,
+           size_t frames, int iterations) {
+    // 增益与其倒数交替施加，信号幅度保持稳定（避免衰减成非规格化数）
+    std::vector<float> up(k.channels), down(k.channels);
+    for (int c = 0; c < k.channels; ++c) {
+        up[c] = 1.25f + 0.25f * c;
+        down[c] = 1.0f / up[c];
+    }
+
+    Timing t;
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        k.ApplyGain(pcm.data(), frames, (i & 1) ? down.data() : up.data());
+    }
+    t.gain_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() /
+                (static_cast<double>(frames) * iterations);
+
+    start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        k.ToFloat(pcm.data(), tmp.data(), frames);
+        k.FromFloat(tmp.data(), pcm.data(), frames);
+    }
+    t.convert_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() /
+                   (static_cast<double>(frames) * iterations);
+    return t;
+}
+
+void FillRandom(std::vector<uint8_t>& pcm, snd_pcm_format_t format) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    const size_t bytes = FormatBytesPerSample(format);
+    for (size_t i = 0; i + bytes <= pcm.size(); i += bytes) {
+        const float x = dist(rng);
+        if (format == SND_PCM_FORMAT_S16_LE) {
+            const int16_t v = SampleTraits<SND_PCM_FORMAT_S16_LE>::FromFloat(x);
+            std::memcpy(&pcm[i], &v, sizeof(v));
+        } else if (format == SND_PCM_FORMAT_S32_LE) {
+            const int32_t v = SampleTraits<SND_PCM_FORMAT_S32_LE>::FromFloat(x);
+            std::memcpy(&pcm[i], &v, sizeof(v));
+        } else {
+            std::memcpy(&pcm[i], &x, sizeof(x));
+        }
+    }
+}
+
+// 限幅器处理 seconds 秒 48kHz 音频所用时间占音频时长的比例
+double LimiterLoad(int channels, bool true_peak, size_t frames, double seconds) {
+    const int rate = 48000;
+    LimiterNode::Config cfg;
+    cfg.true_peak = true_peak;
+    LimiterNode limiter(cfg);
+    limiter.Prepare(rate, channels, frames);
+
+    // 超过上限约 10 dB 的正弦，保证限幅器一直在工作
+    std::vector<float> block(frames * channels);
+    const size_t total = static_cast<size_t>(seconds * rate);
+    double busy = 0.0;
+    for (size_t pos = 0; pos < total; pos += frames) {
+        for (size_t i = 0; i < frames; ++i) {
+            const float v = 3.0f * std::sin(2.0 * M_PI * 997.0 * (pos + i) / rate);
+            for (int c = 0; c < channels; ++c) block[i * channels + c] = v;
+        }
+        const auto start = Clock::now();
+        limiter.Process(block.data(), frames);
+        busy += std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    return busy / (static_cast<double>(total) / rate);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t frames = (argc > 1) ? std::stoul(argv[1]) : 1024;
+    const int iterations = (argc > 2) ? std::stoi(argv[2]) : 20000;
+
+    const snd_pcm_format_t formats[] = {
+        SND_PCM_FORMAT_S16_LE, SND_PCM_FORMAT_S32_LE, SND_PCM_FORMAT_FLOAT_LE,
+    };
+    const char* names[] = {"S16_LE", "S32_LE", "FLOAT_LE"};
+    const int channel_counts[] = {1, 2, 8};
+
+    std::cout << "[Bench] " << frames << " 帧/块, " << iterations << " 次迭代 (ns/帧)\n";
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "format    ch   gain(gen)  gain(spec)  speedup   conv(gen)  conv(spec)  speedup\n";
+
+    for (int f = 0; f < 3; ++f) {
+        for (int ch : channel_counts) {
+            dsp::KernelSet generic, specialized;
+            dsp::SelectGenericKernels(formats[f], ch, &generic);
+            dsp::SelectKernels(formats[f], ch, &specialized);
+
+            std::vector<uint8_t> pcm(frames * generic.frame_bytes);
+            std::vector<float> tmp(frames * ch);
+
+            FillRandom(pcm, formats[f]);
+            const Timing g = Run(generic, pcm, tmp, frames, iterations);
+            FillRandom(pcm, formats[f]);
+            const Timing s = Run(specialized, pcm, tmp, frames, iterations);
+
+            std::cout << std::left << std::setw(9) << names[f] << std::right
+                      << std::setw(3) << ch
+                      << std::setw(11) << g.gain_ns
+                      << std::setw(12) << s.gain_ns
+                      << std::setw(9) << g.gain_ns / s.gain_ns << "x"
+                      << std::setw(11) << g.convert_ns
+                      << std::setw(12) << s.convert_ns
+                      << std::setw(9) << g.convert_ns / s.convert_ns << "x\n";
+        }
+    }
+
+    std::cout << "\n[Bench] 限幅器 @48kHz（占单核百分比）\n"
+              << "ch   sample-peak   true-peak\n";
+    for (int ch : {2, 8, 32}) {
+        std::cout << std::setw(2) << ch
+                  << std::setw(13) << LimiterLoad(ch, false, frames, 10.0) * 100.0 << "%"
+                  << std::setw(11) << LimiterLoad(ch, true, frames, 10.0) * 100.0 << "%\n";
+    }
+    return 0;
+}
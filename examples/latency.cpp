@@ -0,0 +1,382 @@
+#include "alsa_capture.h"
+#include "alsa_playback.h"
+#include "fft.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 往返延迟与抖动测量：通过 AlsaPlayback 播放 MLS（最大长度序列）测试信号，
+// 经环回（物理线缆或 snd-aloop）由 AlsaCapture 录回，互相关求出往返延迟。
+//
+// - 播放与采集用 snd_pcm_link 同时启动，两条流的第 0 帧对齐，延迟按帧精确计算；
+//   无法链接时（例如不同声卡）改用两条流的触发时间戳对齐；
+// - 每个配置连续测量 runs 次，报告分布（最小/平均/中位/最大/标准差）与时钟漂移；
+// - 遍历 周期大小 × 周期数 × 访问方式（读写 / mmap）矩阵，结果写入 CSV，
+//   作为 I/O 路径改动后的回归基准。
+//
+// 用法: arp_latency <play_dev> <cap_dev> <out.csv> [采样率] [通道数] [次数] [周期大小] [周期数] [访问方式]
+//   周期大小/周期数为逗号分隔列表，默认 "64,128,256,512" 与 "2,3,4"
+//   访问方式为 "rw"、"mmap" 或 "rw,mmap"（默认）
+// 示例: modprobe snd-aloop 后
+//   arp_latency hw:Loopback,0 hw:Loopback,1 latency.csv 48000 2 10
+
+namespace {
+
+std::atomic<bool> g_running(true);
+
+void signalHandler(int signum) {
+    if (signum == SIGINT) {
+        g_running = false;
+    }
+}
+
+constexpr int kMlsOrder = 13;             // 8191 帧，48kHz 下约 170ms
+constexpr float kMlsAmplitude = 0.5f;     // -6 dBFS
+constexpr double kMinPeakRatio = 20.0;    // 相关峰与相关噪声 RMS 之比低于此值视为未检测到
+
+// 伽罗瓦 LFSR 生成 ±1 最大长度序列
+std::vector<float> MakeMls(int order) {
+    static const uint32_t kTaps[] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xE08, 0x1C80, 0x3802, 0x6000, 0xD008,
+    };
+    const uint32_t mask = kTaps[order];
+    const size_t length = (size_t{1} << order) - 1;
+    std::vector<float> seq(length);
+    uint32_t state = 1;
+    for (size_t i = 0; i < length; ++i) {
+        const uint32_t bit = state & 1;
+        state >>= 1;
+        if (bit) state ^= mask;
+        seq[i] = bit ? 1.0f : -1.0f;
+    }
+    return seq;
+}
+
+std::vector<std::string> Split(const std::string& s) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) out.push_back(item);
+    }
+    return out;
+}
+
+struct Config {
+    snd_pcm_uframes_t period = 0;
+    unsigned int periods = 0;
+    snd_pcm_access_t access = SND_PCM_ACCESS_RW_INTERLEAVED;
+};
+
+struct Result {
+    std::string status = "ok";
+    snd_pcm_uframes_t play_period = 0, play_buffer = 0;
+    snd_pcm_uframes_t cap_period = 0, cap_buffer = 0;
+    bool linked = false;
+    std::vector<double> latency;  // 每次测量的往返延迟（帧，含小数）
+    std::vector<double> when;     // 对应的测量时刻（秒）
+    uint64_t xruns = 0;
+};
+
+double TriggerTime(snd_pcm_t* handle) {
+    snd_pcm_status_t* status;
+    snd_pcm_status_alloca(&status);
+    if (snd_pcm_status(handle, status) < 0) return 0.0;
+    snd_htimestamp_t ts;
+    snd_pcm_status_get_trigger_htstamp(status, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 在 capture 的 [start, start + fft.size) 窗口中找 MLS 的相关峰。
+// 返回峰值位置（相对 start，抛物线插值到小数帧）；未检测到时返回 -1
+double FindPeak(const dsp::Fft& fft, const std::vector<std::complex<float>>& mls_spectrum,
+                const int16_t* capture, int ch, size_t start, size_t max_lag,
+                std::vector<std::complex<float>>* work) {
+    const size_t n = fft.GetSize();
+    auto& x = *work;
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = std::complex<float>(capture[(start + i) * ch] / 32768.0f, 0.0f);
+    }
+    fft.Forward(x.data());
+    for (size_t i = 0; i < n; ++i) {
+        x[i] *= std::conj(mls_spectrum[i]);
+    }
+    fft.Inverse(x.data());
+
+    size_t best = 0;
+    double best_mag = 0.0, sum_sq = 0.0;
+    for (size_t i = 0; i <= max_lag; ++i) {
+        const double mag = std::fabs(x[i].real());
+        sum_sq += mag * mag;
+        if (mag > best_mag) {
+            best_mag = mag;
+            best = i;
+        }
+    }
+    const double rms = std::sqrt(sum_sq / (max_lag + 1));
+    if (rms <= 0.0 || best_mag / rms < kMinPeakRatio) {
+        return -1.0;
+    }
+
+    double frac = 0.0;
+    if (best > 0 && best < max_lag) {
+        const double y0 = std::fabs(x[best - 1].real());
+        const double y1 = best_mag;
+        const double y2 = std::fabs(x[best + 1].real());
+        const double denom = y0 - 2.0 * y1 + y2;
+        if (denom != 0.0) frac = 0.5 * (y0 - y2) / denom;
+    }
+    return best + frac;
+}
+
+Result Measure(const std::string& play_dev, const std::string& cap_dev,
+               int rate, int ch, int runs, const Config& cfg, const std::vector<float>& mls) {
+    Result r;
+    AlsaPlayback playback(play_dev, rate, ch);
+    AlsaCapture capture(cap_dev, rate, ch);
+    playback.SetPeriodConfig(cfg.period, cfg.periods);
+    capture.SetPeriodConfig(cfg.period, cfg.periods);
+    playback.SetAccess(cfg.access);
+    capture.SetAccess(cfg.access);
+    if (!playback.Open() || !capture.Open()) {
+        r.status = "open_failed";
+        return r;
+    }
+    r.play_period = playback.GetPeriodSize();
+    r.play_buffer = playback.GetBufferSize();
+    r.cap_period = capture.GetPeriodSize();
+    r.cap_buffer = capture.GetBufferSize();
+    r.linked = snd_pcm_link(capture.GetHandle(), playback.GetHandle()) == 0;
+
+    // 可测的最大延迟：两侧缓冲各两倍，再留 50ms 给转换器与线缆
+    const size_t max_lag = 2 * (r.play_buffer + r.cap_buffer) + rate / 20;
+    const size_t length = mls.size();
+    const size_t spacing = length + max_lag;
+    const size_t lead = rate / 4;
+    const size_t signal_frames = lead + runs * spacing;
+    const dsp::Fft fft(dsp::NextPowerOfTwo(length + max_lag));
+    const size_t capture_frames = signal_frames + fft.GetSize();
+
+    // 播放信号：静音引导 + runs 段 MLS，各段之间留出 max_lag 的静音
+    std::vector<int16_t> signal(signal_frames * ch, 0);
+    for (int k = 0; k < runs; ++k) {
+        const size_t p = lead + k * spacing;
+        for (size_t i = 0; i < length; ++i) {
+            const int16_t v = static_cast<int16_t>(mls[i] * kMlsAmplitude * 32767.0f);
+            for (int c = 0; c < ch; ++c) signal[(p + i) * ch + c] = v;
+        }
+    }
+    std::vector<int16_t> recorded(capture_frames * ch, 0);
+    std::vector<int16_t> silence(r.play_period * ch, 0);
+
+    const size_t frame_bytes = sizeof(int16_t) * ch;
+    size_t play_pos = 0, cap_pos = 0;
+    auto write_upto = [&](size_t target) -> bool {
+        while (play_pos < target) {
+            const size_t n = std::min<size_t>(r.play_period, target - play_pos);
+            const int16_t* src = play_pos < signal_frames ? &signal[play_pos * ch] : silence.data();
+            const size_t avail = play_pos < signal_frames ? std::min(n, signal_frames - play_pos) : n;
+            int written = 0;
+            if (!playback.WriteFrame(reinterpret_cast<const uint8_t*>(src), avail * frame_bytes, &written) ||
+                written <= 0) {
+                return false;
+            }
+            play_pos += static_cast<size_t>(written);
+        }
+        return true;
+    };
+
+    // 写满播放缓冲（第一次写入即启动播放；已链接时采集同时启动）
+    if (!write_upto(r.play_buffer)) {
+        r.status = "xrun";
+        return r;
+    }
+    double offset_frames = 0.0;
+    bool offset_known = r.linked;
+    while (g_running && cap_pos < capture_frames) {
+        int got = 0;
+        const size_t want = std::min<size_t>(r.cap_period, capture_frames - cap_pos);
+        if (!capture.ReadFrame(reinterpret_cast<uint8_t*>(&recorded[cap_pos * ch]),
+                               want * frame_bytes, &got) || got <= 0) {
+            r.status = "xrun";
+            break;
+        }
+        cap_pos += static_cast<size_t>(got);
+        if (!offset_known) {
+            // 未链接：用触发时间戳换算两条流起点的差（采集晚启动则为正）
+            offset_frames = (TriggerTime(capture.GetHandle()) -
+                             TriggerTime(playback.GetHandle())) * rate;
+            offset_known = true;
+        }
+        if (capture.GetXrunCount() > 0) {
+            // 时间轴已断开，后续测量无效
+            r.status = "xrun";
+            break;
+        }
+        if (!write_upto(cap_pos + r.play_buffer)) {
+            r.status = "xrun";
+            break;
+        }
+    }
+    r.xruns = capture.GetXrunCount() + (r.status == "xrun" ? 1 : 0);
+    if (r.linked) {
+        snd_pcm_unlink(capture.GetHandle());
+    }
+    playback.Close();
+    capture.Close();
+    if (r.status != "ok") return r;
+    if (!g_running) {
+        r.status = "interrupted";
+        return r;
+    }
+
+    // MLS 频谱只算一次
+    std::vector<std::complex<float>> mls_spectrum(fft.GetSize());
+    for (size_t i = 0; i < length; ++i) mls_spectrum[i] = std::complex<float>(mls[i], 0.0f);
+    fft.Forward(mls_spectrum.data());
+
+    std::vector<std::complex<float>> work(fft.GetSize());
+    const long offset_int = std::lround(offset_frames);
+    for (int k = 0; k < runs; ++k) {
+        const long p = static_cast<long>(lead + k * spacing);
+        // 第 k 段在采集流中的起点不早于 p - offset
+        const size_t start = static_cast<size_t>(std::max(0L, p - offset_int));
+        const double peak = FindPeak(fft, mls_spectrum, recorded.data(), ch, start, max_lag, &work);
+        if (peak < 0.0) continue;
+        r.latency.push_back(static_cast<double>(start) + peak - p + offset_frames);
+        r.when.push_back(static_cast<double>(p) / rate);
+    }
+    if (r.latency.empty()) {
+        r.status = "no_signal";
+    }
+    return r;
+}
+
+struct Stats {
+    double min = 0, max = 0, mean = 0, median = 0, stddev = 0, drift_ppm = 0;
+};
+
+Stats Summarize(const Result& r, int rate) {
+    Stats s;
+    const size_t n = r.latency.size();
+    if (n == 0) return s;
+    std::vector<double> sorted = r.latency;
+    std::sort(sorted.begin(), sorted.end());
+    s.min = sorted.front();
+    s.max = sorted.back();
+    s.median = (n % 2) ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+    for (double v : sorted) s.mean += v;
+    s.mean /= n;
+    for (double v : sorted) s.stddev += (v - s.mean) * (v - s.mean);
+    s.stddev = std::sqrt(s.stddev / n);
+
+    // 漂移：延迟对测量时刻做最小二乘直线拟合，斜率（帧/秒）换算为 ppm
+    if (n >= 2) {
+        double mt = 0, ml = 0;
+        for (size_t i = 0; i < n; ++i) { mt += r.when[i]; ml += r.latency[i]; }
+        mt /= n;
+        ml /= n;
+        double num = 0, den = 0;
+        for (size_t i = 0; i < n; ++i) {
+            num += (r.when[i] - mt) * (r.latency[i] - ml);
+            den += (r.when[i] - mt) * (r.when[i] - mt);
+        }
+        if (den > 0) s.drift_ppm = num / den / rate * 1e6;
+    }
+    return s;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "用法: " << argv[0]
+                  << " <play_dev> <cap_dev> <out.csv> [采样率] [通道数] [次数] [周期大小] [周期数] [访问方式]\n"
+                  << "示例: " << argv[0] << " hw:Loopback,0 hw:Loopback,1 latency.csv 48000 2 10 64,128,256 2,3 rw,mmap\n";
+        return 1;
+    }
+    std::signal(SIGINT, signalHandler);
+
+    const std::string play_dev = argv[1];
+    const std::string cap_dev  = argv[2];
+    const std::string csv_file = argv[3];
+    const int rate = (argc > 4) ? std::stoi(argv[4]) : 48000;
+    const int ch   = (argc > 5) ? std::stoi(argv[5]) : 2;
+    const int runs = (argc > 6) ? std::max(1, std::stoi(argv[6])) : 10;
+    const auto period_list = Split((argc > 7) ? argv[7] : "64,128,256,512");
+    const auto count_list  = Split((argc > 8) ? argv[8] : "2,3,4");
+    const auto access_list = Split((argc > 9) ? argv[9] : "rw,mmap");
+
+    std::ofstream csv(csv_file);
+    if (!csv) {
+        std::cerr << "无法创建 CSV 文件: " << csv_file << "\n";
+        return 1;
+    }
+    csv << "period,periods,access,play_period,play_buffer,cap_period,cap_buffer,linked,status,"
+           "runs,valid,min_frames,mean_frames,median_frames,max_frames,stddev_frames,"
+           "jitter_frames,mean_ms,drift_ppm,xruns\n";
+
+    const std::vector<float> mls = MakeMls(kMlsOrder);
+    std::vector<std::string> summary;
+
+    for (const auto& access_name : access_list) {
+        Config cfg;
+        if (access_name == "rw") {
+            cfg.access = SND_PCM_ACCESS_RW_INTERLEAVED;
+        } else if (access_name == "mmap") {
+            cfg.access = SND_PCM_ACCESS_MMAP_INTERLEAVED;
+        } else {
+            std::cerr << "未知访问方式: " << access_name << "\n";
+            continue;
+        }
+        for (const auto& period : period_list) {
+            for (const auto& count : count_list) {
+                if (!g_running) break;
+                cfg.period = static_cast<snd_pcm_uframes_t>(std::stoul(period));
+                cfg.periods = static_cast<unsigned int>(std::stoul(count));
+
+                const Result r = Measure(play_dev, cap_dev, rate, ch, runs, cfg, mls);
+                const Stats s = Summarize(r, rate);
+
+                char line[512];
+                std::snprintf(line, sizeof(line),
+                              "%s,%u,%s,%lu,%lu,%lu,%lu,%d,%s,%d,%zu,%.2f,%.2f,%.2f,%.2f,%.3f,%.2f,%.3f,%.2f,%llu",
+                              period.c_str(), cfg.periods, access_name.c_str(),
+                              static_cast<unsigned long>(r.play_period),
+                              static_cast<unsigned long>(r.play_buffer),
+                              static_cast<unsigned long>(r.cap_period),
+                              static_cast<unsigned long>(r.cap_buffer),
+                              r.linked ? 1 : 0, r.status.c_str(), runs, r.latency.size(),
+                              s.min, s.mean, s.median, s.max, s.stddev, s.max - s.min,
+                              s.mean * 1000.0 / rate, s.drift_ppm,
+                              static_cast<unsigned long long>(r.xruns));
+                csv << line << "\n";
+                csv.flush();
+
+                char brief[256];
+                std::snprintf(brief, sizeof(brief),
+                              "[Latency] %-4s period=%-5s x%-2u %-11s %3zu/%d  mean %.2f ms (%.1f 帧)  抖动 %.2f 帧  漂移 %.2f ppm",
+                              access_name.c_str(), period.c_str(), cfg.periods, r.status.c_str(),
+                              r.latency.size(), runs, s.mean * 1000.0 / rate, s.mean,
+                              s.max - s.min, s.drift_ppm);
+                summary.push_back(brief);
+                std::cout << brief << std::endl;
+            }
+        }
+    }
+
+    std::cout << "\n========== 汇总 ==========\n";
+    for (const auto& line : summary) std::cout << line << "\n";
+    std::cout << "[Latency] CSV: " << csv_file << "\n";
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include <fstream>
 #include <signal.h>
 #include <atomic>
+#include <vector>
 
 std::atomic<bool> g_running(true);
 
@@ -28,8 +29,15 @@ int main(int argc, char* argv[]) {
     int channels = 2;
     std::string input_file = argv[1];
 
+    // 文件回放对延迟不敏感，使用吞吐模式：25ms 周期、16 个周期的缓冲，
+    // 每次写入 8 个周期，内核每空出 8 个周期才唤醒一次
+    const unsigned int kPeriods = 16;
+    const unsigned int kWakeupPeriods = 8;
+
     // 创建ALSA播放对象
     AlsaPlayback playback(device, sample_rate, channels);
+    playback.SetPeriodConfig(sample_rate / 40, kPeriods);
+    playback.SetWakeupPeriods(kWakeupPeriods);
 
     // 打开设备
     if (!playback.Open()) {
@@ -49,9 +57,10 @@ int main(int argc, char* argv[]) {
     std::cout << "设备: " << device << std::endl;
     std::cout << "采样率: " << sample_rate << "Hz, 通道数: " << channels << std::endl;
 
-    // 分配缓冲区
-    const int buffer_size = 16384;
-    uint8_t buffer[buffer_size];
+    // 分配缓冲区：一次写入一个唤醒间隔的数据
+    const size_t buffer_size = playback.GetPeriodSize() * kWakeupPeriods * channels * playback.GetBytesPerSample();
+    std::vector<uint8_t> storage(buffer_size);
+    uint8_t* buffer = storage.data();
     int frames_written;
     int consecutive_errors = 0;  // 连续错误计数
     const int MAX_CONSECUTIVE_ERRORS = 5;  // 最大连续错误次数
@@ -71,7 +80,7 @@ int main(int argc, char* argv[]) {
                           << MAX_CONSECUTIVE_ERRORS << ")" << std::endl;
                 
                 // 尝试恢复设备
-                if (playback.Recover(err)) {
+                if (playback.Recover(-EPIPE)) {
                     std::cout << "设备已恢复" << std::endl;
                     consecutive_errors = 0;  // 重置错误计数
                 } else {
@@ -0,0 +1,94 @@
+#include "alsa_capture.h"
+#include "capture_history.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 回溯录音：内存中持续保存最近若干秒，收到 SIGUSR1 时把事件前后的音频写盘
+//
+// 用法: arp_preroll [设备] [历史秒数] [事件前秒数] [事件后秒数]
+// 触发: kill -USR1 <pid>
+
+static std::atomic<bool> g_running(true);
+static std::atomic<int> g_triggers(0);
+
+static void signalHandler(int signum) {
+    if (signum == SIGINT) {
+        std::cout << "\n[Signal] Ctrl+C\n";
+        g_running = false;
+    } else if (signum == SIGUSR1) {
+        g_triggers.fetch_add(1);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGUSR1, signalHandler);
+
+    const std::string device = (argc > 1) ? argv[1] : "hw:0";
+    const double history_s   = (argc > 2) ? std::stod(argv[2]) : 300.0;
+    const double before_s    = (argc > 3) ? std::stod(argv[3]) : 10.0;
+    const double after_s     = (argc > 4) ? std::stod(argv[4]) : 5.0;
+    const int rate = 44100;
+    const int ch   = 2;
+
+    AlsaCapture capture(device, rate, ch);
+    if (!capture.Open()) {
+        std::cerr << "Capture 打开失败\n";
+        return 1;
+    }
+
+    CaptureHistory history(rate, ch, capture.GetBytesPerSample(), history_s);
+    if (!history.Open(/*use_hugepages*/true, /*lock_memory*/true)) {
+        capture.Close();
+        return 2;
+    }
+
+    // 控制线程：处理触发（快照请求不在采集线程中发出）
+    std::thread th_ctl([&]{
+        int handled = 0;
+        while (g_running) {
+            const int triggers = g_triggers.load();
+            while (handled < triggers) {
+                ++handled;
+                const std::string path = "event_" + std::to_string(std::time(nullptr)) + "_" +
+                                         std::to_string(handled) + ".pcm";
+                std::cout << "[Trigger] 保存事件前 " << before_s << " 秒、后 " << after_s
+                          << " 秒到 " << path << "\n";
+                history.RequestSnapshot(before_s, after_s, path);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    });
+
+    const size_t frame_bytes = static_cast<size_t>(ch) * capture.GetBytesPerSample();
+    std::vector<uint8_t> buf(capture.GetPeriodSize() * frame_bytes);
+    int frames_read = 0;
+
+    std::cout << "开始监听，kill -USR1 " << getpid() << " 触发保存，Ctrl+C 退出..." << std::endl;
+    while (g_running) {
+        if (!capture.ReadFrame(buf.data(), buf.size(), &frames_read) || frames_read <= 0) {
+            if (!capture.Recover()) {
+                std::cerr << "[Capture] 读取失败，恢复失败，退出\n";
+                break;
+            }
+            continue;
+        }
+        history.Write(buf.data(), frames_read);
+    }
+
+    g_running = false;
+    th_ctl.join();
+    history.Close();  // 已排队的快照写出已采集到的部分后停止
+    capture.Close();
+    std::cout << "[Main] 共保存 " << history.GetCompletedSnapshots() << " 个快照\n";
+    return 0;
+}
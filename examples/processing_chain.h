@@ -0,0 +1,50 @@
+#ifndef EXAMPLES_PROCESSING_CHAIN_H
+#define EXAMPLES_PROCESSING_CHAIN_H
+
+#include <memory>
+
+#include "dsp_chain.h"
+#include "dsp_nodes.h"
+#include "dsp_watchdog.h"
+#include "limiter_node.h"
+#include "plugin_node.h"
+
+// arp_duplex（实时）与 arp_batch（离线）共用的处理链定义，
+// 保证离线重处理得到与现场完全相同的结果。
+//
+//   20Hz 高通（去直流） -> 增益 -> 插件槽 -> 前瞻限幅（-1 dBTP）
+//
+// 增益调高时由限幅器平滑压住峰值，不再依赖转换回整数时的硬削波。
+// 插件槽默认直通，duplex 运行时可热替换插件，限幅器始终在其后兜底。
+struct ProcessingChainHandles {
+    GainNode* gain;      // 供控制线程调整增益
+    PluginNode* plugin;  // 供控制线程加载/卸载插件
+};
+
+inline ProcessingChainHandles BuildProcessingChain(DspChain* chain, float gain) {
+    chain->AddNode(std::make_unique<BiquadNode>(BiquadNode::Type::kHighPass, 20.0, 0.707));
+    auto gain_node = std::make_unique<GainNode>(gain);
+    auto plugin_node = std::make_unique<PluginNode>();
+    ProcessingChainHandles handles{gain_node.get(), plugin_node.get()};
+    chain->AddNode(std::move(gain_node));
+    chain->AddNode(std::move(plugin_node));
+    chain->AddNode(std::make_unique<LimiterNode>());
+    return handles;
+}
+
+// 实时处理的降级级别（按听感损失从小到大）：
+//   1. 限幅器只检测样本峰值（关闭 4 倍过采样），样本间峰值可能略超上限
+//   2. 旁路 20Hz 高通：只影响直流/次声，几乎听不出差别
+// 增益、插件与限幅属于必需功能，不参与旁路。离线处理不注册降级，始终全质量。
+inline void RegisterDegradationLevels(DspChain* chain, DspLoadWatchdog* watchdog) {
+    auto* limiter = static_cast<LimiterNode*>(chain->GetNode(3));
+    watchdog->AddLevel("limiter sample-peak", [limiter](bool engage) {
+        limiter->SetTruePeak(!engage);
+    });
+    DspNode* highpass = chain->GetNode(0);
+    watchdog->AddLevel("bypass highpass", [highpass](bool engage) {
+        highpass->SetBypassed(engage);
+    });
+}
+
+#endif  // EXAMPLES_PROCESSING_CHAIN_H
@@ -1,8 +1,14 @@
 #include "alsa_capture.h"
+#include "dsp_kernels.h"
+#include "gated_pcm.h"
+#include "period_pool.h"
+#include "vad.h"
 #include <iostream>
 #include <fstream>
 #include <signal.h>
 #include <atomic>
+#include <algorithm>
+#include <memory>
 
 std::atomic<bool> g_running(true);
 
@@ -22,9 +28,18 @@ int main(int argc, char* argv[]) {
     int sample_rate = 44100;
     int channels = 2;
     std::string output_file = (argc > 1) ? argv[1] : "recording.pcm";
+    // 第二个参数为 vad 时只保存活动通道，静音存为间隙标记（.gpcm，用 arp_expand 还原）
+    const bool use_vad = (argc > 2) && std::string(argv[2]) == "vad";
+
+    // 录音对延迟不敏感，使用吞吐模式：25ms 周期、16 个周期（400ms）的缓冲，
+    // 每 8 个周期（200ms）唤醒一次并一次读走所有已到达的数据，系统调用与文件写入次数降为 1/8
+    const unsigned int kPeriods = 16;
+    const unsigned int kWakeupPeriods = 8;
 
     // 创建ALSA捕获对象
     AlsaCapture capture(device, sample_rate, channels);
+    capture.SetPeriodConfig(sample_rate / 40, kPeriods);
+    capture.SetWakeupPeriods(kWakeupPeriods);
 
     // 打开设备
     if (!capture.Open()) {
@@ -33,21 +48,41 @@ int main(int argc, char* argv[]) {
     }
 
     // 打开输出文件
-    std::ofstream outfile(output_file, std::ios::binary);
-    if (!outfile.is_open()) {
-        std::cerr << "无法创建输出文件: " << output_file << std::endl;
-        capture.Close();
-        return 1;
+    std::ofstream outfile;
+    GatedPcmWriter gated;
+    dsp::KernelSet kernels;
+    std::unique_ptr<VoiceActivityDetector> vad;
+    if (use_vad) {
+        if (!dsp::SelectKernels(capture.GetFormat(), channels, &kernels) ||
+            !gated.Open(output_file, sample_rate, channels, capture.GetFormat())) {
+            capture.Close();
+            return 1;
+        }
+        vad = std::make_unique<VoiceActivityDetector>(sample_rate, channels);
+    } else {
+        outfile.open(output_file, std::ios::binary);
+        if (!outfile.is_open()) {
+            std::cerr << "无法创建输出文件: " << output_file << std::endl;
+            capture.Close();
+            return 1;
+        }
     }
 
     std::cout << "开始录制，按Ctrl+C停止..." << std::endl;
     std::cout << "设备: " << device << std::endl;
     std::cout << "采样率: " << sample_rate << "Hz, 通道数: " << channels << std::endl;
-    std::cout << "输出文件: " << output_file << std::endl;
+    std::cout << "输出文件: " << output_file << (use_vad ? " (VAD 间隙压缩)" : "") << std::endl;
 
-    // 分配缓冲区
-    const int buffer_size = 16384;
-    uint8_t buffer[buffer_size];
+    // 分配缓冲区：从周期块池取一个能容纳整个 ALSA 缓冲的块（大页、锁定、预缺页），
+    // 一次读取不会被截断，录制过程中不再触发缺页
+    PeriodPool pool;
+    if (!pool.Init(capture.GetBufferSize(), channels * capture.GetBytesPerSample(), 1)) {
+        capture.Close();
+        return 1;
+    }
+    PeriodPool::Block block = pool.Acquire();
+    const size_t buffer_size = block.capacity_bytes();
+    uint8_t* buffer = block.data();
     int frames_read;
     int consecutive_errors = 0;  // 连续错误计数
     const int MAX_CONSECUTIVE_ERRORS = 5;  // 最大连续错误次数
@@ -56,8 +91,13 @@ int main(int argc, char* argv[]) {
     while (g_running) {
         if (capture.ReadFrame(buffer, buffer_size, &frames_read)) {
             // 写入文件
-            outfile.write(reinterpret_cast<char*>(buffer), 
-                         frames_read * channels * capture.GetBytesPerSample());
+            if (vad) {
+                vad->ProcessInterleaved(kernels, buffer, frames_read);
+                if (!gated.Write(buffer, frames_read, vad->GetActiveMask())) break;
+            } else {
+                outfile.write(reinterpret_cast<char*>(buffer), 
+                             frames_read * channels * capture.GetBytesPerSample());
+            }
             consecutive_errors = 0;  // 重置错误计数
         } else {
             consecutive_errors++;
@@ -79,7 +119,16 @@ int main(int argc, char* argv[]) {
     }
 
     // 清理资源
-    outfile.close();
+    if (vad) {
+        gated.Close();
+        const double total = static_cast<double>(std::max<uint64_t>(1, vad->GetTotalFrames()));
+        std::cout << "VAD: 活动 " << vad->GetActiveFrames() * 100.0 / total << "% 的时间, 通道占空比 "
+                  << vad->GetActiveChannelFrames() * 100.0 / (total * channels) << "%, 写入 "
+                  << gated.GetBytesWritten() << " 字节 (原始 " << gated.GetRawBytes() << " 字节)"
+                  << std::endl;
+    } else {
+        outfile.close();
+    }
     capture.Close();
 
     std::cout << "录制已完成，文件已保存为: " << output_file << std::endl;
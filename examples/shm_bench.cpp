@@ -0,0 +1,220 @@
+#include "shm_capture_publisher.h"
+#include "shm_capture_subscriber.h"
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 共享采集基准：合成数据按真实周期节奏发布，测量 1/4/16 个订阅进程的
+// 端到端延迟（发布时刻 -> 订阅端取到数据）与 CPU 占用。无需音频硬件。
+//
+// 用法: arp_shm_bench [秒数] [周期帧数]
+
+namespace {
+
+struct SubscriberResult {
+    uint64_t periods;
+    uint64_t skipped;
+    uint64_t invalid;
+    double p50_us;
+    double p99_us;
+    double max_us;
+    double cpu_s;
+};
+
+int64_t MonotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+double ThreadCpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 订阅子进程：读取直到发布端关闭，把统计写回管道
+void RunSubscriber(const std::string& path, size_t expected_periods, int result_fd) {
+    ShmCaptureSubscriber sub(path);
+    // 等待发布端开始监听。路径在 bind 时就已出现，listen 之前连接会被拒绝，
+    // 所以路径出现之后仍要在期限内重试 Open
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (access(path.c_str(), F_OK) != 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    bool opened = sub.Open();
+    while (!opened && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        opened = sub.Open();
+    }
+    if (!opened) {
+        // 不写回结果，父进程按结果数发现缺少的订阅端
+        return;
+    }
+
+    SubscriberResult res;
+    std::memset(&res, 0, sizeof(res));
+    std::vector<int64_t> latencies;
+    latencies.reserve(expected_periods + 1024);
+    volatile uint32_t checksum = 0;
+
+    ShmCaptureSubscriber::Period period;
+    while (true) {
+        auto st = sub.Acquire(&period, 1000);
+        if (st == ShmCaptureSubscriber::ReadStatus::kClosed) break;
+        if (st == ShmCaptureSubscriber::ReadStatus::kTimeout) continue;
+        latencies.push_back(MonotonicNs() - period.timestamp_ns);
+
+        // 模拟消费：在共享内存中直接遍历数据
+        uint32_t sum = 0;
+        for (size_t i = 0; i < period.bytes; i += 64) sum += period.data[i];
+        checksum = checksum + sum;
+
+        if (!sub.Validate(period)) ++res.invalid;
+    }
+
+    rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    res.cpu_s = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 +
+                ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+    res.periods = latencies.size();
+    res.skipped = sub.GetSkippedPeriods();
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        res.p50_us = latencies[latencies.size() / 2] / 1000.0;
+        res.p99_us = latencies[latencies.size() * 99 / 100] / 1000.0;
+        res.max_us = latencies.back() / 1000.0;
+    }
+    ssize_t w = write(result_fd, &res, sizeof(res));
+    (void)w;
+}
+
+void RunCase(int subscribers, double seconds, int period_frames) {
+    const int rate = 48000;
+    const int ch = 2;
+    const size_t period_bytes = static_cast<size_t>(period_frames) * ch * sizeof(int16_t);
+    const size_t periods = static_cast<size_t>(seconds * rate / period_frames);
+    const std::string path = "/tmp/arp_shm_bench_" + std::to_string(getpid()) + ".sock";
+
+    int pipefd[2];
+    if (pipe(pipefd) < 0) {
+        std::cerr << "无法创建管道\n";
+        return;
+    }
+
+    // 先 fork 订阅进程（此时父进程还没有任何线程），fork 前清空输出缓冲
+    std::cout.flush();
+    std::vector<pid_t> children;
+    for (int i = 0; i < subscribers; ++i) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(pipefd[0]);
+            RunSubscriber(path, periods, pipefd[1]);
+            _exit(0);
+        }
+        children.push_back(pid);
+    }
+    close(pipefd[1]);
+
+    ShmCapturePublisher pub(path, rate, ch, SND_PCM_FORMAT_S16_LE);
+    if (!pub.Open(period_bytes, 64)) {
+        close(pipefd[0]);
+        for (pid_t pid : children) {
+            waitpid(pid, nullptr, 0);
+        }
+        return;
+    }
+    const auto wait_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (pub.GetServedSubscribers() < subscribers &&
+           std::chrono::steady_clock::now() < wait_deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    // 按真实周期节奏发布
+    const int64_t period_ns = static_cast<int64_t>(period_frames) * 1000000000LL / rate;
+    timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    const double cpu_start = ThreadCpuSeconds();
+    for (size_t n = 0; n < periods; ++n) {
+        uint8_t* dst = pub.BeginWrite();
+        std::memset(dst, static_cast<int>(n & 0xff), period_bytes);
+        pub.CommitWrite(period_frames, period_bytes);
+
+        next.tv_nsec += period_ns;
+        while (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            ++next.tv_sec;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+    }
+    const double pub_cpu = ThreadCpuSeconds() - cpu_start;
+    pub.Close();
+
+    std::vector<SubscriberResult> results;
+    SubscriberResult res;
+    while (read(pipefd[0], &res, sizeof(res)) == static_cast<ssize_t>(sizeof(res))) {
+        results.push_back(res);
+    }
+    close(pipefd[0]);
+    for (pid_t pid : children) {
+        waitpid(pid, nullptr, 0);
+    }
+    if (results.empty()) {
+        std::cerr << "没有订阅端结果\n";
+        return;
+    }
+    if (results.size() != static_cast<size_t>(subscribers)) {
+        std::cerr << "警告: 只有 " << results.size() << "/" << subscribers
+                  << " 个订阅端连接成功，以下统计只包含这些订阅端\n";
+    }
+
+    std::vector<double> p50s;
+    double p99 = 0, max_us = 0, cpu = 0;
+    uint64_t skipped = 0, invalid = 0;
+    for (const auto& r : results) {
+        p50s.push_back(r.p50_us);
+        p99 = std::max(p99, r.p99_us);
+        max_us = std::max(max_us, r.max_us);
+        cpu += r.cpu_s;
+        skipped += r.skipped;
+        invalid += r.invalid;
+    }
+    std::sort(p50s.begin(), p50s.end());
+
+    std::cout << std::setw(4) << subscribers
+              << std::setw(10) << periods
+              << std::setw(10) << p50s[p50s.size() / 2]
+              << std::setw(10) << p99
+              << std::setw(10) << max_us
+              << std::setw(12) << (cpu / results.size()) / seconds * 100.0
+              << std::setw(12) << pub_cpu / seconds * 100.0
+              << std::setw(9) << skipped
+              << std::setw(9) << invalid << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const double seconds = (argc > 1) ? std::stod(argv[1]) : 5.0;
+    const int period_frames = (argc > 2) ? std::stoi(argv[2]) : 256;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "[Bench] 48000Hz 2ch S16, 周期 " << period_frames << " 帧, 每组 " << seconds << " 秒\n";
+    std::cout << " sub   periods   p50(us)   p99(us)   max(us)  sub_cpu(%)  pub_cpu(%)  skipped  invalid\n";
+    for (int n : {1, 4, 16}) {
+        RunCase(n, seconds, period_frames);
+    }
+    return 0;
+}
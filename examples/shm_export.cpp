@@ -0,0 +1,66 @@
+#include "alsa_capture.h"
+#include "shm_capture_publisher.h"
+
+#include <atomic>
+#include <csignal>
+#include <iostream>
+#include <string>
+
+// 独占采集设备，把每个周期直接读入共享内存环，供其他本地进程订阅
+//
+// 用法: arp_shm_export [设备] [套接字路径]
+
+static std::atomic<bool> g_running(true);
+static void signalHandler(int signum) {
+    if (signum == SIGINT || signum == SIGTERM) {
+        std::cout << "\n[Signal] 停止发布\n";
+        g_running = false;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    const std::string device      = (argc > 1) ? argv[1] : "hw:0";
+    const std::string socket_path = (argc > 2) ? argv[2] : "/tmp/arp_capture.sock";
+    const int rate = 44100;
+    const int ch   = 2;
+
+    AlsaCapture capture(device, rate, ch);
+    if (!capture.Open()) {
+        std::cerr << "Capture 打开失败\n";
+        return 1;
+    }
+
+    const size_t frame_bytes  = static_cast<size_t>(ch) * capture.GetBytesPerSample();
+    const size_t period_bytes = capture.GetPeriodSize() * frame_bytes;
+
+    // 约 64 个周期的共享历史，足够订阅端吸收调度抖动
+    ShmCapturePublisher publisher(socket_path, rate, ch, capture.GetFormat());
+    if (!publisher.Open(period_bytes, 64)) {
+        capture.Close();
+        return 2;
+    }
+
+    std::cout << "开始发布，按Ctrl+C停止..." << std::endl;
+    int frames_read = 0;
+    while (g_running) {
+        // ALSA 直接写入共享槽位，无中间缓冲
+        uint8_t* dst = publisher.BeginWrite();
+        if (!capture.ReadFrame(dst, period_bytes, &frames_read) || frames_read <= 0) {
+            if (!capture.Recover()) {
+                std::cerr << "[Capture] 读取失败，恢复失败，退出\n";
+                break;
+            }
+            continue;
+        }
+        publisher.CommitWrite(frames_read, static_cast<size_t>(frames_read) * frame_bytes);
+    }
+
+    std::cout << "[Main] 已发布 " << publisher.GetPublished() << " 个周期，服务 "
+              << publisher.GetServedSubscribers() << " 个订阅端\n";
+    publisher.Close();
+    capture.Close();
+    return 0;
+}
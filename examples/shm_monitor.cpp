@@ -0,0 +1,75 @@
+#include "shm_capture_subscriber.h"
+
+#include <atomic>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// 共享采集的订阅示例：电平监视。只链接客户端库，不需要 ALSA，也不打开任何设备
+//
+// 用法: arp_shm_monitor [套接字路径]
+
+static std::atomic<bool> g_running(true);
+static void signalHandler(int signum) {
+    if (signum == SIGINT) {
+        g_running = false;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::signal(SIGINT, signalHandler);
+
+    const std::string socket_path = (argc > 1) ? argv[1] : "/tmp/arp_capture.sock";
+
+    ShmCaptureSubscriber sub(socket_path);
+    if (!sub.Open()) {
+        return 1;
+    }
+    if (sub.GetBytesPerFrame() != sub.GetChannels() * 2) {
+        std::cerr << "本示例只处理 S16 格式\n";
+        return 2;
+    }
+
+    int peak = 0;
+    int frames = 0;
+    ShmCaptureSubscriber::Period period;
+    while (g_running) {
+        auto st = sub.Acquire(&period, 500);
+        if (st == ShmCaptureSubscriber::ReadStatus::kClosed) {
+            std::cout << "[Monitor] 发布端已关闭\n";
+            break;
+        }
+        if (st == ShmCaptureSubscriber::ReadStatus::kTimeout) {
+            continue;
+        }
+
+        // 直接在共享内存中计算峰值
+        int block_peak = 0;
+        const int16_t* s = reinterpret_cast<const int16_t*>(period.data);
+        const size_t n = period.bytes / sizeof(int16_t);
+        for (size_t i = 0; i < n; ++i) {
+            const int v = std::abs(static_cast<int>(s[i]));
+            if (v > block_peak) block_peak = v;
+        }
+        // 读取期间被覆盖的数据不可信，丢弃
+        if (!sub.Validate(period)) {
+            continue;
+        }
+        if (block_peak > peak) peak = block_peak;
+
+        frames += period.frames;
+        if (frames >= sub.GetSampleRate()) {
+            const double dbfs = peak > 0 ? 20.0 * std::log10(peak / 32768.0) : -120.0;
+            std::cout << "[Monitor] peak " << dbfs << " dBFS, lag " << sub.GetLag()
+                      << ", skipped " << sub.GetSkippedPeriods() << "\n";
+            peak = 0;
+            frames = 0;
+        }
+    }
+
+    sub.Close();
+    return 0;
+}
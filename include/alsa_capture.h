@@ -45,10 +45,37 @@ class AlsaCapture {
   
   // 设置格式
   bool SetFormat(snd_pcm_format_t format);
+
+  // 设置周期大小（帧）与周期数，须在 Open 之前调用。
+  // 未设置时使用默认的 100ms 缓冲、4 个周期
+  bool SetPeriodConfig(snd_pcm_uframes_t period_frames, unsigned int periods);
+
+  // 设置访问方式：SND_PCM_ACCESS_RW_INTERLEAVED（默认）或
+  // SND_PCM_ACCESS_MMAP_INTERLEAVED（ReadFrame 改用 snd_pcm_mmap_readi）
+  bool SetAccess(snd_pcm_access_t access);
+  snd_pcm_access_t GetAccess() const { return access_; }
+
+  // 吞吐模式：每攒够 periods 个周期才唤醒一次（sw_params 的 avail_min），须在 Open 之前调用。
+  // 此时 ReadFrame 不再按周期截断，而是先查 snd_pcm_avail_update，
+  // 一次读走所有可用帧（受 buffer_size 限制），唤醒与系统调用次数约降为 1/periods。
+  // 适合录音等对延迟不敏感的消费者；缓冲区须容纳 periods + 1 个周期，否则按缓冲区收紧；
+  // 缓冲区不足两个周期时退回低延迟模式并打印警告。
+  // 0 或 1 为默认的低延迟模式（每周期一次）。
+  bool SetWakeupPeriods(unsigned int periods);
+  unsigned int GetWakeupPeriods() const { return wakeup_periods_; }
+
+  // ReadFrame 内部自动恢复过的 xrun 次数
+  uint64_t GetXrunCount() const { return xrun_count_; }
+
+  // 原始句柄（snd_pcm_link、状态查询等）
+  snd_pcm_t* GetHandle() const { return handle_; }
   
  private:
   // 设置音频参数
   bool SetParams();
+
+  // 吞吐模式的一次读取：等到 avail_min 后读走所有可用帧，返回帧数或负的错误码
+  snd_pcm_sframes_t ReadAvailable(uint8_t* buffer, snd_pcm_uframes_t max_frames);
   
   // 设备路径
   std::string device_;
@@ -64,6 +91,14 @@ class AlsaCapture {
   snd_pcm_uframes_t period_size_;
 
   snd_pcm_format_t format_;  // 添加格式成员变量
+  size_t frame_bytes_;       // 每帧字节数，Open 时计算
+
+  snd_pcm_uframes_t requested_period_;  // SetPeriodConfig 请求的周期大小（0 = 默认）
+  unsigned int requested_periods_;      // SetPeriodConfig 请求的周期数
+  snd_pcm_access_t access_;
+  unsigned int wakeup_periods_;         // SetWakeupPeriods 请求的唤醒间隔（周期数）
+  snd_pcm_uframes_t avail_min_;         // Open 时实际设置的 avail_min（帧）
+  uint64_t xrun_count_;
 };
 
 #endif  // MCMS_RTSP_STREAM_ALSA_CAPTURE_H_ 
\ No newline at end of file
@@ -16,6 +16,30 @@ public:
     int GetBytesPerSample() const;
     snd_pcm_format_t GetFormat() const;
     bool SetFormat(snd_pcm_format_t format);
+
+    // 设置周期大小（帧）与周期数，须在 Open 之前调用。
+    // 未设置时只固定 100ms 缓冲，周期大小由驱动决定
+    bool SetPeriodConfig(snd_pcm_uframes_t period_frames, unsigned int periods);
+
+    // 设置访问方式：SND_PCM_ACCESS_RW_INTERLEAVED（默认）或
+    // SND_PCM_ACCESS_MMAP_INTERLEAVED（WriteFrame 改用 snd_pcm_mmap_writei）
+    bool SetAccess(snd_pcm_access_t access);
+    snd_pcm_access_t GetAccess() const { return access_; }
+
+    // 吞吐模式：设置 avail_min 为 periods 个周期，须在 Open 之前调用。
+    // 阻塞的 WriteFrame 一次写入多个周期时，内核只在空出 periods 个周期后唤醒一次，
+    // 而不是每个周期一次。缓冲区须容纳 periods + 1 个周期，否则按缓冲区收紧；
+    // 缓冲区不足两个周期时退回每周期唤醒并打印警告。
+    // 0 或 1 为默认（每周期唤醒）。
+    bool SetWakeupPeriods(unsigned int periods);
+    unsigned int GetWakeupPeriods() const { return wakeup_periods_; }
+
+    // 硬件最终确定的缓冲区与周期大小（帧），Open 之后有效
+    snd_pcm_uframes_t GetBufferSize() const { return buffer_size_; }
+    snd_pcm_uframes_t GetPeriodSize() const { return period_size_; }
+
+    // 原始句柄（snd_pcm_link、状态查询等）
+    snd_pcm_t* GetHandle() const { return handle_; }
 private:
     bool SetParams();
 
@@ -24,6 +48,14 @@ private:
     int channels_;
     snd_pcm_t* handle_;  // 修改为正确的类型
     snd_pcm_format_t format_;  // 添加格式成员变量
+    size_t frame_bytes_;       // 每帧字节数，SetParams 时计算
+
+    snd_pcm_uframes_t requested_period_;  // SetPeriodConfig 请求的周期大小（0 = 默认）
+    unsigned int requested_periods_;
+    snd_pcm_access_t access_;
+    unsigned int wakeup_periods_;  // SetWakeupPeriods 请求的唤醒间隔（周期数）
+    snd_pcm_uframes_t buffer_size_;
+    snd_pcm_uframes_t period_size_;
 };
 
 #endif // ALSA_PLAYBACK_H 
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef ARP_PLUGIN_H
+#define ARP_PLUGIN_H
+
+/*
+ * 处理插件的 C ABI（稳定接口，插件只需包含本头文件，不链接 arp_core）。
+ *
+ * 插件是一个共享库，导出函数
+ *
+ *     const arp_plugin_descriptor* arp_plugin_entry(void);
+ *
+ * 返回的描述符在库卸载之前一直有效。宿主（PluginNode）的调用约定：
+ *
+ *   - create / prepare / destroy 在后台线程调用，可以分配内存、读文件、加载模型；
+ *   - process / reset 在音频线程调用，不允许分配、加锁或阻塞；
+ *   - 同一实例的所有调用都是串行的，不同实例之间没有共享状态的要求；
+ *   - 样本为交错 float（满量程 ±1.0），就地处理，frames 不超过 prepare 时的 max_frames。
+ *
+ * api_version 与 ARP_PLUGIN_API_VERSION 不一致的插件会被拒绝加载。
+ */
+
+#include <stdint.h>
+
+#define ARP_PLUGIN_API_VERSION 1
+#define ARP_PLUGIN_ENTRY_SYMBOL "arp_plugin_entry"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct arp_plugin_descriptor {
+  uint32_t api_version;  /* 必须为 ARP_PLUGIN_API_VERSION */
+  const char* name;      /* 插件名，用于日志（可为 NULL，宿主改用库路径） */
+
+  /* 创建实例。config 为宿主传入的配置字符串（可能为空串），失败返回 NULL */
+  void* (*create)(const char* config);
+
+  /* 按采样率、通道数与单次最大帧数准备实例，成功返回 0 */
+  int (*prepare)(void* instance, int sample_rate, int channels, uint32_t max_frames);
+
+  /* 就地处理 frames 帧 */
+  void (*process)(void* instance, float* samples, uint32_t frames);
+
+  /* 清空内部状态（可为 NULL） */
+  void (*reset)(void* instance);
+
+  /* 销毁实例 */
+  void (*destroy)(void* instance);
+} arp_plugin_descriptor;
+
+typedef const arp_plugin_descriptor* (*arp_plugin_entry_fn)(void);
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif  /* ARP_PLUGIN_H */
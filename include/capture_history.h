@@ -0,0 +1,77 @@
+#ifndef CAPTURE_HISTORY_H
+#define CAPTURE_HISTORY_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "huge_buffer.h"
+
+// 回溯录音（pre-roll）缓冲：在内存中循环保存最近 N 秒的采集数据，
+// 事件触发时把触发点前后的时间窗异步写盘，采集不中断。
+//
+// 采集线程只做 memcpy 与一次原子写入；快照请求排队交给后台线程，
+// 后台线程等时间窗的数据采齐后分块写出。写盘过程中若目标数据已被
+// 新数据覆盖（时间窗超过保存时长），会跳过被覆盖的部分并告警。
+class CaptureHistory {
+ public:
+  CaptureHistory(int sample_rate, int channels, int bytes_per_sample, double seconds);
+  ~CaptureHistory();
+
+  CaptureHistory(const CaptureHistory&) = delete;
+  CaptureHistory& operator=(const CaptureHistory&) = delete;
+
+  // 分配历史缓冲并启动写盘线程。use_hugepages/lock_memory 见 HugeBuffer
+  bool Open(bool use_hugepages, bool lock_memory);
+
+  // 停止写盘线程并释放缓冲。已排队的快照只写出已采集到的部分，
+  // 不再等待触发点之后尚未到达的数据
+  void Close();
+
+  // 采集线程调用：追加交错数据（无分配、无锁）。
+  // 单次写入须小于容量的 1/16（写盘线程的安全距离），通常为一个周期
+  void Write(const uint8_t* data, int frames);
+
+  // 请求保存 [触发时刻 - seconds_before, 触发时刻 + seconds_after] 的数据到 path。
+  // 立即返回；不要在实时线程中调用
+  bool RequestSnapshot(double seconds_before, double seconds_after, const std::string& path);
+
+  // 获取属性与统计
+  bool IsOpened() const { return buffer_.data() != nullptr; }
+  uint64_t GetCapacityFrames() const { return capacity_frames_; }
+  uint64_t GetTotalFrames() const { return total_frames_.load(std::memory_order_acquire); }
+  int GetCompletedSnapshots() const { return completed_.load(std::memory_order_relaxed); }
+  bool IsHugePages() const { return buffer_.IsHugePages(); }
+
+ private:
+  struct SnapshotRequest {
+    uint64_t start_frame;
+    uint64_t end_frame;
+    std::string path;
+  };
+
+  void WriterLoop();
+  bool SaveSnapshot(const SnapshotRequest& req);
+
+  int sample_rate_;
+  int channels_;
+  size_t frame_bytes_;
+  uint64_t capacity_frames_;
+
+  HugeBuffer buffer_;
+  std::atomic<uint64_t> total_frames_{0};  // 累计写入帧数
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<SnapshotRequest> requests_;
+  std::atomic<bool> stop_{false};
+  std::thread writer_;
+  std::atomic<int> completed_{0};
+};
+
+#endif  // CAPTURE_HISTORY_H
@@ -0,0 +1,115 @@
+#ifndef DSP_CHAIN_H
+#define DSP_CHAIN_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "dsp_kernels.h"
+
+// 处理节点：就地处理交错 float（满量程 ±1.0）。
+//
+// Prepare 在非实时线程中调用，可以分配内存；Process/Reset 在音频线程中调用，
+// 不允许分配、加锁或阻塞。
+class DspNode {
+ public:
+  virtual ~DspNode() = default;
+
+  virtual const char* GetName() const = 0;
+
+  // 按采样率、通道数与单次最大帧数准备内部状态
+  virtual bool Prepare(int sample_rate, int channels, size_t max_frames) {
+    sample_rate_ = sample_rate;
+    channels_ = channels;
+    max_frames_ = max_frames;
+    return true;
+  }
+
+  // 就地处理 frames 帧（frames <= max_frames）
+  virtual void Process(float* samples, size_t frames) = 0;
+
+  // 清空内部状态（滤波器历史、延迟线等）
+  virtual void Reset() {}
+
+  // 状态收敛所需的帧数：离线分块处理时每块要提前这么多帧开始预热
+  virtual size_t GetWarmupFrames() const { return 0; }
+
+  // 节点引入的延迟（帧）
+  virtual size_t GetLatencyFrames() const { return 0; }
+
+  // 非活动块（VAD 判定整块静音）是否仍要运行。默认跳过：链输出静音，
+  // 节点在下一个活动块之前自动 Reset。只观察输出的节点（如电平表）应返回 true
+  virtual bool RunsWhenInactive() const { return false; }
+
+  // 旁路：被旁路的节点不参与处理（用于 CPU 过载时降级）。
+  // 解除旁路后节点会在下一次处理前自动 Reset，避免使用过时的状态
+  void SetBypassed(bool bypassed) {
+    if (!bypassed && bypassed_.load(std::memory_order_relaxed)) {
+      reset_pending_.store(true, std::memory_order_relaxed);
+    }
+    bypassed_.store(bypassed, std::memory_order_release);
+  }
+  bool IsBypassed() const { return bypassed_.load(std::memory_order_acquire); }
+
+ protected:
+  int sample_rate_ = 0;
+  int channels_ = 0;
+  size_t max_frames_ = 0;
+
+ private:
+  friend class DspChain;
+  std::atomic<bool> bypassed_{false};
+  std::atomic<bool> reset_pending_{false};
+};
+
+// 串行处理链。duplex 的实时回调与 arp_batch 的离线处理使用同一条链。
+class DspChain {
+ public:
+  DspChain() = default;
+
+  DspChain(const DspChain&) = delete;
+  DspChain& operator=(const DspChain&) = delete;
+
+  // 追加节点（须在 Prepare 之前）
+  void AddNode(std::unique_ptr<DspNode> node);
+
+  // 取走所有节点（例如交给 DspPipeline 分级），链随后为空
+  std::vector<std::unique_ptr<DspNode>> TakeNodes();
+
+  // 准备所有节点并分配转换缓冲
+  bool Prepare(int sample_rate, int channels, size_t max_frames);
+
+  // 就地处理交错 float，超过 max_frames 时自动分块。
+  // active 为 false（整块静音）时输出静音，只运行 RunsWhenInactive 的节点
+  void Process(float* samples, size_t frames, bool active = true);
+
+  // 交错 PCM 入口：按选定内核转换为 float，处理后转换回原格式（饱和）
+  void ProcessInterleaved(const dsp::KernelSet& kernels, uint8_t* pcm, size_t frames,
+                          bool active = true);
+
+  // 清空所有节点状态
+  void Reset();
+
+  // 整条链的预热帧数与延迟（各节点之和）
+  size_t GetWarmupFrames() const;
+  size_t GetLatencyFrames() const;
+
+  size_t GetNodeCount() const { return nodes_.size(); }
+  DspNode* GetNode(size_t index) const { return nodes_[index].get(); }
+  int GetSampleRate() const { return sample_rate_; }
+  int GetChannels() const { return channels_; }
+  size_t GetMaxFrames() const { return max_frames_; }
+
+ private:
+  void RunNodes(float* samples, size_t frames, bool active);
+
+  std::vector<std::unique_ptr<DspNode>> nodes_;
+  std::vector<float> scratch_;  // ProcessInterleaved 的转换缓冲
+  int sample_rate_ = 0;
+  int channels_ = 0;
+  size_t max_frames_ = 0;
+};
+
+#endif  // DSP_CHAIN_H
@@ -0,0 +1,124 @@
+#ifndef DSP_KERNELS_H
+#define DSP_KERNELS_H
+
+#include <cstddef>
+#include <alsa/asoundlib.h>
+
+#include "frame_traits.h"
+
+// 按 <格式, 通道数> 特化的转换与处理内核。
+//
+// 常用组合（S16/S32/FLOAT × 1/2/8 通道）在 dsp_kernels.cpp 中显式实例化；
+// 其余通道数走运行期通道数的通用版本。调用方在 Open 之后用 SelectKernels
+// 选定一次，之后热路径只有一次间接调用，不再有格式 switch。
+
+namespace dsp {
+
+// ---------- 编译期特化内核 ----------
+
+// 交错整数/浮点样本 -> 交错 float（满量程 ±1.0）
+template <snd_pcm_format_t Format, int Channels>
+void ToFloat(const void* in, float* out, size_t frames) {
+  using F = Frame<Format, Channels>;
+  const typename F::Sample* __restrict src = static_cast<const typename F::Sample*>(in);
+  float* __restrict dst = out;
+  for (size_t i = 0; i < frames * Channels; ++i) {
+    dst[i] = F::Traits::ToFloat(src[i]);
+  }
+}
+
+// 交错 float -> 交错样本（饱和）
+template <snd_pcm_format_t Format, int Channels>
+void FromFloat(const float* in, void* out, size_t frames) {
+  using F = Frame<Format, Channels>;
+  const float* __restrict src = in;
+  typename F::Sample* __restrict dst = static_cast<typename F::Sample*>(out);
+  for (size_t i = 0; i < frames * Channels; ++i) {
+    dst[i] = F::Traits::FromFloat(src[i]);
+  }
+}
+
+// 就地施加逐通道增益（饱和）。内层通道循环次数为常量，可完全展开
+template <snd_pcm_format_t Format, int Channels>
+void ApplyGain(void* samples, size_t frames, const float* gains) {
+  using F = Frame<Format, Channels>;
+  typename F::Sample* __restrict s = static_cast<typename F::Sample*>(samples);
+  float g[Channels];
+  for (int c = 0; c < Channels; ++c) g[c] = gains[c];
+  for (size_t i = 0; i < frames; ++i) {
+    for (int c = 0; c < Channels; ++c) {
+      const size_t k = i * Channels + c;
+      s[k] = F::Traits::Saturate(static_cast<float>(s[k]) * g[c]);
+    }
+  }
+}
+
+// ---------- 运行期通道数的通用版本 ----------
+
+template <snd_pcm_format_t Format>
+void ToFloatGeneric(const void* in, float* out, size_t frames, int channels) {
+  using T = SampleTraits<Format>;
+  const typename T::Type* src = static_cast<const typename T::Type*>(in);
+  for (size_t i = 0; i < frames * channels; ++i) {
+    out[i] = T::ToFloat(src[i]);
+  }
+}
+
+template <snd_pcm_format_t Format>
+void FromFloatGeneric(const float* in, void* out, size_t frames, int channels) {
+  using T = SampleTraits<Format>;
+  typename T::Type* dst = static_cast<typename T::Type*>(out);
+  for (size_t i = 0; i < frames * channels; ++i) {
+    dst[i] = T::FromFloat(in[i]);
+  }
+}
+
+template <snd_pcm_format_t Format>
+void ApplyGainGeneric(void* samples, size_t frames, int channels, const float* gains) {
+  using T = SampleTraits<Format>;
+  typename T::Type* s = static_cast<typename T::Type*>(samples);
+  for (size_t i = 0; i < frames; ++i) {
+    for (int c = 0; c < channels; ++c) {
+      const size_t k = i * channels + c;
+      s[k] = T::Saturate(static_cast<float>(s[k]) * gains[c]);
+    }
+  }
+}
+
+// ---------- 运行期分派 ----------
+
+// 一组为某个 <格式, 通道数> 选定的内核
+struct KernelSet {
+  using ToFloatFn   = void (*)(const void* in, float* out, size_t frames, int channels);
+  using FromFloatFn = void (*)(const float* in, void* out, size_t frames, int channels);
+  using GainFn      = void (*)(void* samples, size_t frames, int channels, const float* gains);
+
+  ToFloatFn to_float = nullptr;
+  FromFloatFn from_float = nullptr;
+  GainFn apply_gain = nullptr;
+
+  snd_pcm_format_t format = SND_PCM_FORMAT_UNKNOWN;
+  int channels = 0;
+  size_t frame_bytes = 0;
+  bool specialized = false;  // 是否命中编译期特化版本
+
+  void ToFloat(const void* in, float* out, size_t frames) const {
+    to_float(in, out, frames, channels);
+  }
+  void FromFloat(const float* in, void* out, size_t frames) const {
+    from_float(in, out, frames, channels);
+  }
+  void ApplyGain(void* samples, size_t frames, const float* gains) const {
+    apply_gain(samples, frames, channels, gains);
+  }
+};
+
+// 按格式与通道数选择内核；格式不受支持时返回 false
+bool SelectKernels(snd_pcm_format_t format, int channels, KernelSet* out);
+
+// 强制选择通用版本（用于基准对比）
+bool SelectGenericKernels(snd_pcm_format_t format, int channels, KernelSet* out);
+
+}  // namespace dsp
+
+#endif  // DSP_KERNELS_H
@@ -0,0 +1,53 @@
+#ifndef DSP_NODES_H
+#define DSP_NODES_H
+
+#include <atomic>
+#include <vector>
+
+#include "dsp_chain.h"
+
+// 增益节点：增益可由控制线程随时修改，音频线程每块读取一次
+class GainNode : public DspNode {
+ public:
+  explicit GainNode(float gain = 1.0f) : gain_(gain) {}
+
+  const char* GetName() const override { return "gain"; }
+  void Process(float* samples, size_t frames) override;
+
+  void SetGain(float gain) { gain_.store(gain, std::memory_order_relaxed); }
+  float GetGain() const { return gain_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<float> gain_;
+};
+
+// 二阶 IIR 滤波节点（RBJ Audio EQ Cookbook，直接 II 型转置结构），逐通道独立状态
+class BiquadNode : public DspNode {
+ public:
+  enum class Type { kLowPass, kHighPass, kPeak };
+
+  // freq_hz: 截止/中心频率；q: 品质因数；gain_db: 仅 kPeak 使用
+  BiquadNode(Type type, double freq_hz, double q, double gain_db = 0.0);
+
+  const char* GetName() const override { return "biquad"; }
+  bool Prepare(int sample_rate, int channels, size_t max_frames) override;
+  void Process(float* samples, size_t frames) override;
+  void Reset() override;
+
+  // 冲激响应衰减到 -100 dB 所需的帧数
+  size_t GetWarmupFrames() const override { return warmup_frames_; }
+
+ private:
+  Type type_;
+  double freq_hz_;
+  double q_;
+  double gain_db_;
+
+  // 低频滤波器极点接近单位圆，系数与状态用 double 避免舍入噪声
+  double b0_ = 1.0, b1_ = 0.0, b2_ = 0.0, a1_ = 0.0, a2_ = 0.0;
+  std::vector<double> z1_;  // 每通道状态
+  std::vector<double> z2_;
+  size_t warmup_frames_ = 0;
+};
+
+#endif  // DSP_NODES_H
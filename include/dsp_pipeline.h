@@ -0,0 +1,118 @@
+#ifndef DSP_PIPELINE_H
+#define DSP_PIPELINE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "dsp_chain.h"
+#include "dsp_kernels.h"
+#include "spsc_queue.h"
+
+// 多核流水线处理：把一条处理链切成若干级，每级在独立的（绑核、实时优先级）线程上运行，
+// 级与级之间通过无锁 SPSC 队列传递周期缓冲的下标。
+//
+// 单声道/立体声素材无法按通道并行；流水线让第 k 级处理第 n 个周期的同时
+// 第 k+1 级处理第 n-1 个周期，吞吐量随级数近似线性增长，
+// 代价是输出比输入晚 latency_periods 个周期（Prepare 时指定，默认等于级数）。
+//
+// 调用方（duplex 的播放线程）每个周期调用一次 Process：送入本周期，
+// 取回 latency_periods 个周期之前送入、已走完所有级的结果。
+// 前 latency_periods 次调用输出静音。
+class DspPipeline {
+ public:
+  explicit DspPipeline(size_t stage_count);
+  ~DspPipeline();
+
+  DspPipeline(const DspPipeline&) = delete;
+  DspPipeline& operator=(const DspPipeline&) = delete;
+
+  size_t GetStageCount() const { return stages_.size(); }
+  DspChain* GetStage(size_t index) { return &stages_[index]->chain; }
+
+  // 把 chain 的节点依次分配给各级：split[i] 为第 i 级的节点数；
+  // split 为空时按节点数平均分配。须在 Prepare 之前调用，chain 之后为空
+  bool Partition(DspChain* chain, const std::vector<size_t>& split = {});
+
+  // 准备各级与周期缓冲。latency_periods 为 0 时取级数；
+  // 各级耗时之和小于 latency_periods 个周期时才不会拖慢输出
+  bool Prepare(const dsp::KernelSet& kernels, int sample_rate, int channels,
+               size_t max_frames, size_t latency_periods = 0);
+
+  // 启动各级线程。cpus[i] 为第 i 级绑定的 CPU（为空时依次绑定 1, 2, ...，-1 表示不绑定）；
+  // rt_priority > 0 时使用 SCHED_FIFO，权限不足只打印警告
+  bool Start(const std::vector<int>& cpus = {}, int rt_priority = 70);
+
+  // 停止并等待各级线程退出；可与调用方线程的 Process 并发，
+  // 阻塞在 Process 中的调用方会被唤醒并返回 0
+  void Stop();
+
+  // 调用方线程：就地把 pcm 替换为 latency_periods 个周期之前的处理结果，
+  // 返回输出帧数（停止后返回 0）。frames 超过 max_frames 的部分被忽略。
+  // active 随周期一起传给各级（见 DspChain::Process）
+  size_t Process(uint8_t* pcm, size_t frames, bool active = true);
+
+  // 流水线引入的额外延迟
+  size_t GetLatencyPeriods() const { return latency_periods_; }
+  size_t GetLatencyFrames() const { return latency_periods_ * max_frames_; }
+
+  // 各级负载（处理耗时 / 周期时长）：滑动平均、峰值与最近一个周期
+  double GetStageLoad(size_t index) const;
+  double GetStagePeakLoad(size_t index) const;
+  double GetStageLastLoad(size_t index) const;
+  // 最近一个周期中最忙一级的负载（供 DspLoadWatchdog::Update 使用）
+  double GetMaxStageLastLoad() const;
+
+  // 调用方取结果时不得不等待的次数（各级耗时之和超出了 latency_periods 个周期）
+  uint64_t GetStalls() const { return stalls_.load(std::memory_order_relaxed); }
+
+ private:
+  // 相邻两级之间的交接：无锁队列 + futex 唤醒
+  struct Handoff {
+    explicit Handoff(size_t capacity) : queue(capacity) {}
+    void Push(uint32_t slot);
+    // 阻塞直到取到下标；停止且队列为空时返回 false
+    bool Pop(uint32_t* slot, const std::atomic<bool>& running);
+    void WakeAll();
+
+    SpscQueue<uint32_t> queue;
+    std::atomic<uint32_t> seq{0};      // futex 字，每次入队加一
+    std::atomic<uint32_t> waiters{0};  // 正在等待的线程数
+  };
+
+  struct Stage {
+    DspChain chain;
+    std::thread thread;
+    std::atomic<double> load{0.0};
+    std::atomic<double> peak_load{0.0};
+    std::atomic<double> last_load{0.0};
+  };
+
+  struct Slot {
+    std::vector<float> samples;
+    size_t frames = 0;
+    bool active = true;
+  };
+
+  void StageLoop(size_t index, int cpu, int rt_priority);
+
+  std::vector<std::unique_ptr<Stage>> stages_;
+  std::vector<std::unique_ptr<Handoff>> handoffs_;  // stages_.size() + 1 个
+  std::vector<Slot> slots_;
+  std::vector<uint32_t> free_slots_;  // 仅调用方线程访问
+  size_t in_flight_ = 0;              // 仅调用方线程访问
+
+  dsp::KernelSet kernels_;
+  int sample_rate_ = 0;
+  int channels_ = 0;
+  size_t max_frames_ = 0;
+  size_t latency_periods_ = 0;
+
+  std::atomic<bool> running_{false};
+  std::atomic<uint64_t> stalls_{0};
+};
+
+#endif  // DSP_PIPELINE_H
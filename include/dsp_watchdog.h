@@ -0,0 +1,92 @@
+#ifndef DSP_WATCHDOG_H
+#define DSP_WATCHDOG_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 实时处理的 CPU 预算看门狗。
+//
+// 音频线程在每块处理前后调用 BeginPeriod/EndPeriod，看门狗以
+// “处理耗时 / 该块音频时长” 作为负载，并维护指数滑动平均：
+//
+// - 平均负载连续 degrade_periods 块高于 degrade_threshold，或单块超时
+//   （负载 > 1，即已经吃掉了整个周期），启用下一个降级级别。每次降级后
+//   至少等 degrade_periods 块让平均值收敛再判断下一级，单块超时也不例外；
+// - 平均负载连续 recover_periods 块低于 recover_threshold，撤销最近一个级别。
+//
+// 两个阈值之间的间隔与较长的恢复等待构成迟滞，避免在临界负载下来回切换。
+// 降级级别按注册顺序依次启用，应从“听感损失最小”的开始注册。
+//
+// AddLevel 须在开始处理之前调用；engage 回调在音频线程中执行，
+// 只允许做无锁、无分配的操作（例如设置节点旁路或原子参数）。
+class DspLoadWatchdog {
+ public:
+  struct Config {
+    double degrade_threshold = 0.75;  // 平均负载高于此值时降级
+    double recover_threshold = 0.45;  // 平均负载低于此值时恢复
+    int degrade_periods = 4;          // 持续超阈值多少块后降级（两次降级之间的最小间隔）
+    int recover_periods = 400;        // 持续低于阈值多少块后恢复一级
+    double smoothing = 0.1;           // 滑动平均系数（0~1，越大越灵敏）
+  };
+
+  // engage(true) 进入该级别，engage(false) 退出
+  using EngageFn = std::function<void(bool)>;
+
+  explicit DspLoadWatchdog(int sample_rate);
+  DspLoadWatchdog(int sample_rate, const Config& config);
+
+  DspLoadWatchdog(const DspLoadWatchdog&) = delete;
+  DspLoadWatchdog& operator=(const DspLoadWatchdog&) = delete;
+
+  // 注册降级级别
+  void AddLevel(const std::string& name, EngageFn engage);
+
+  // 音频线程：frames 为本块的帧数，截止时间 = frames / sample_rate
+  void BeginPeriod() { begin_ = std::chrono::steady_clock::now(); }
+  void EndPeriod(size_t frames);
+
+  // 直接提交一个周期的负载（耗时已由别处测得，例如 DspPipeline 中最忙一级的负载）
+  void Update(double load);
+
+  // 以下可在任意线程读取
+  double GetLoad() const { return load_.load(std::memory_order_relaxed); }
+  double GetPeakLoad() const { return peak_load_.load(std::memory_order_relaxed); }
+  int GetLevel() const { return level_.load(std::memory_order_relaxed); }
+  int GetLevelCount() const { return static_cast<int>(levels_.size()); }
+  const std::string& GetLevelName(int index) const { return levels_[index].name; }
+  uint64_t GetOverruns() const { return overruns_.load(std::memory_order_relaxed); }
+  uint64_t GetDegradeCount() const { return degrades_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Level {
+    std::string name;
+    EngageFn engage;
+  };
+
+  void StepDown();
+  void StepUp();
+
+  const int sample_rate_;
+  const Config config_;
+  std::vector<Level> levels_;
+
+  // 仅音频线程访问
+  std::chrono::steady_clock::time_point begin_;
+  double avg_ = 0.0;
+  int over_count_ = 0;
+  int under_count_ = 0;
+
+  // 供其他线程读取的统计
+  std::atomic<double> load_{0.0};
+  std::atomic<double> peak_load_{0.0};
+  std::atomic<int> level_{0};  // 当前已启用的级别数
+  std::atomic<uint64_t> overruns_{0};
+  std::atomic<uint64_t> degrades_{0};
+};
+
+#endif  // DSP_WATCHDOG_H
@@ -0,0 +1,45 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace dsp {
+
+// 基 2 复数 FFT（就地，迭代实现）。
+//
+// 构造时预先计算旋转因子与位反转表，Forward/Inverse 不分配内存，
+// 可在分析线程中反复使用。大小必须是 2 的幂。
+class Fft {
+ public:
+  explicit Fft(size_t size);
+
+  size_t GetSize() const { return size_; }
+
+  // 正变换：X[k] = sum x[n] e^{-j2πkn/N}
+  void Forward(std::complex<float>* data) const;
+
+  // 逆变换，结果已除以 N
+  void Inverse(std::complex<float>* data) const;
+
+ private:
+  void Transform(std::complex<float>* data, bool inverse) const;
+
+  size_t size_;
+  std::vector<std::complex<float>> twiddle_;  // e^{-j2πk/N}, k < N/2
+  std::vector<size_t> bitrev_;
+};
+
+inline bool IsPowerOfTwo(size_t n) { return n != 0 && (n & (n - 1)) == 0; }
+
+// 不小于 n 的最小 2 的幂
+inline size_t NextPowerOfTwo(size_t n) {
+  size_t p = 1;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+}  // namespace dsp
+
+#endif  // FFT_H
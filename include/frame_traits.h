@@ -0,0 +1,123 @@
+#ifndef FRAME_TRAITS_H
+#define FRAME_TRAITS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <alsa/asoundlib.h>
+
+// 编译期的采样格式与帧描述。内核按 <格式, 通道数> 实例化后，
+// 帧大小、样本类型、缩放系数都是常量，编译器可以完全展开并向量化。
+//
+// 只描述本机字节序（小端）的常用格式：S16_LE / S32_LE / FLOAT_LE。
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "frame_traits.h 只支持小端平台"
+#endif
+
+template <snd_pcm_format_t Format>
+struct SampleTraits;
+
+// 16 位有符号整数，满量程 ±32768
+template <>
+struct SampleTraits<SND_PCM_FORMAT_S16_LE> {
+  using Type = int16_t;
+  static constexpr const char* kName = "S16_LE";
+  static constexpr float kScale = 32768.0f;
+  static constexpr float kMin = -32768.0f;
+  static constexpr float kMax = 32767.0f;
+
+  static inline float ToFloat(Type s) { return static_cast<float>(s) * (1.0f / kScale); }
+  // x 为整数量程内的值（未归一化），饱和后截断
+  static inline Type Saturate(float x) {
+    x = x < kMin ? kMin : x;
+    x = x > kMax ? kMax : x;
+    return static_cast<Type>(x);
+  }
+  static inline Type FromFloat(float x) { return Saturate(x * kScale); }
+};
+
+// 32 位有符号整数；kMax 取小于 2^31 的最大 float，避免转换溢出
+template <>
+struct SampleTraits<SND_PCM_FORMAT_S32_LE> {
+  using Type = int32_t;
+  static constexpr const char* kName = "S32_LE";
+  static constexpr float kScale = 2147483648.0f;
+  static constexpr float kMin = -2147483648.0f;
+  static constexpr float kMax = 2147483520.0f;
+
+  static inline float ToFloat(Type s) { return static_cast<float>(s) * (1.0f / kScale); }
+  static inline Type Saturate(float x) {
+    x = x < kMin ? kMin : x;
+    x = x > kMax ? kMax : x;
+    return static_cast<Type>(x);
+  }
+  static inline Type FromFloat(float x) { return Saturate(x * kScale); }
+};
+
+// 32 位浮点，满量程 ±1.0
+template <>
+struct SampleTraits<SND_PCM_FORMAT_FLOAT_LE> {
+  using Type = float;
+  static constexpr const char* kName = "FLOAT_LE";
+  static constexpr float kScale = 1.0f;
+  static constexpr float kMin = -1.0f;
+  static constexpr float kMax = 1.0f;
+
+  static inline float ToFloat(Type s) { return s; }
+  static inline Type Saturate(float x) {
+    x = x < kMin ? kMin : x;
+    x = x > kMax ? kMax : x;
+    return x;
+  }
+  static inline Type FromFloat(float x) { return Saturate(x); }
+};
+
+// 一帧交错数据：Channels 个同格式样本
+template <snd_pcm_format_t Format, int Channels>
+struct Frame {
+  using Traits = SampleTraits<Format>;
+  using Sample = typename Traits::Type;
+
+  static constexpr snd_pcm_format_t kFormat = Format;
+  static constexpr int kChannels = Channels;
+  static constexpr size_t kBytesPerSample = sizeof(Sample);
+  static constexpr size_t kBytes = sizeof(Sample) * Channels;
+
+  Sample samples[Channels];
+};
+
+static_assert(sizeof(Frame<SND_PCM_FORMAT_S16_LE, 2>) == 4, "帧必须紧密排列");
+static_assert(sizeof(Frame<SND_PCM_FORMAT_S32_LE, 8>) == 32, "帧必须紧密排列");
+
+// 运行期格式的每样本字节数（只在 Open 等非热路径使用）
+constexpr int FormatBytesPerSample(snd_pcm_format_t format) {
+  switch (format) {
+    case SND_PCM_FORMAT_S8:
+    case SND_PCM_FORMAT_U8:
+      return 1;
+    case SND_PCM_FORMAT_S16_LE:
+    case SND_PCM_FORMAT_S16_BE:
+    case SND_PCM_FORMAT_U16_LE:
+    case SND_PCM_FORMAT_U16_BE:
+      return 2;
+    // ALSA 的 S24_LE 等格式以 32 位容器存放（低 24 位有效）
+    case SND_PCM_FORMAT_S24_LE:
+    case SND_PCM_FORMAT_S24_BE:
+    case SND_PCM_FORMAT_U24_LE:
+    case SND_PCM_FORMAT_U24_BE:
+    case SND_PCM_FORMAT_S32_LE:
+    case SND_PCM_FORMAT_S32_BE:
+    case SND_PCM_FORMAT_U32_LE:
+    case SND_PCM_FORMAT_U32_BE:
+    case SND_PCM_FORMAT_FLOAT_LE:
+    case SND_PCM_FORMAT_FLOAT_BE:
+      return 4;
+    case SND_PCM_FORMAT_FLOAT64_LE:
+    case SND_PCM_FORMAT_FLOAT64_BE:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+#endif  // FRAME_TRAITS_H
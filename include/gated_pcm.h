@@ -0,0 +1,100 @@
+#ifndef GATED_PCM_H
+#define GATED_PCM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <alsa/asoundlib.h>
+
+// 带间隙标记的 PCM 文件（.gpcm）：只存 VAD 判为活动的通道，静音存成间隙标记。
+//
+// 文件头（32 字节，小端）：
+//   "ARPG" | version u16 | channels u16 | sample_rate u32 | format i32 |
+//   bytes_per_sample u16 | reserved u16 | reserved u32 | total_frames u64（Close 时回填）
+// 之后是连续的记录：
+//   frames u32 | mask[(channels + 7) / 8] | 载荷
+// mask 的第 c 位表示第 c 通道活动；载荷为 frames 帧、只含活动通道的交错样本。
+// mask 全 0 的记录就是间隙标记，没有载荷，相邻的间隙会合并成一条。
+//
+// 展开（GatedPcmReader）得到与原始交错 PCM 时间轴逐帧对齐的数据：
+// 活动通道的样本逐字节还原，静音通道与间隙填入该格式的静音值。
+class GatedPcmWriter {
+ public:
+  GatedPcmWriter() = default;
+  ~GatedPcmWriter();
+
+  GatedPcmWriter(const GatedPcmWriter&) = delete;
+  GatedPcmWriter& operator=(const GatedPcmWriter&) = delete;
+
+  bool Open(const std::string& path, int sample_rate, int channels, snd_pcm_format_t format);
+
+  // 写入一块交错 PCM；active_mask 为 nullptr 时视为全部通道活动
+  bool Write(const uint8_t* data, size_t frames, const uint8_t* active_mask);
+
+  // 写出未决的间隙、回填总帧数并关闭
+  bool Close();
+
+  bool IsOpened() const { return file_.is_open(); }
+  uint64_t GetTotalFrames() const { return total_frames_; }
+  uint64_t GetGapFrames() const { return gap_frames_; }
+  uint64_t GetBytesWritten() const { return bytes_written_; }
+  // 同样内容按原始交错 PCM 存放所需的字节数
+  uint64_t GetRawBytes() const { return total_frames_ * channels_ * bytes_per_sample_; }
+
+ private:
+  bool FlushGap();
+  bool WriteRecord(uint32_t frames, const uint8_t* mask, const uint8_t* payload, size_t bytes);
+
+  std::ofstream file_;
+  int channels_ = 0;
+  int bytes_per_sample_ = 0;
+  size_t mask_bytes_ = 0;
+  std::vector<uint8_t> zero_mask_;
+  std::vector<uint8_t> full_mask_;
+  std::vector<uint8_t> packed_;  // 活动通道的载荷
+  uint64_t pending_gap_ = 0;     // 尚未写出的连续间隙帧数
+  uint64_t total_frames_ = 0;
+  uint64_t gap_frames_ = 0;
+  uint64_t bytes_written_ = 0;
+};
+
+class GatedPcmReader {
+ public:
+  GatedPcmReader() = default;
+
+  GatedPcmReader(const GatedPcmReader&) = delete;
+  GatedPcmReader& operator=(const GatedPcmReader&) = delete;
+
+  bool Open(const std::string& path);
+  void Close();
+
+  // 展开最多 max_frames 帧到 out（全部通道交错）；到达文件末尾时 *frames_read 为 0。
+  // 文件截断或损坏时返回 false
+  bool Read(uint8_t* out, size_t max_frames, size_t* frames_read);
+
+  int GetSampleRate() const { return sample_rate_; }
+  int GetChannels() const { return channels_; }
+  snd_pcm_format_t GetFormat() const { return format_; }
+  int GetBytesPerSample() const { return bytes_per_sample_; }
+  // 文件头记录的总帧数（写入端未正常关闭时为 0）
+  uint64_t GetTotalFrames() const { return total_frames_; }
+
+ private:
+  std::ifstream file_;
+  int sample_rate_ = 0;
+  int channels_ = 0;
+  snd_pcm_format_t format_ = SND_PCM_FORMAT_UNKNOWN;
+  int bytes_per_sample_ = 0;
+  uint64_t total_frames_ = 0;
+
+  std::vector<uint8_t> mask_;        // 当前记录
+  std::vector<int> active_;          // 当前记录的活动通道
+  uint64_t remaining_ = 0;           // 当前记录未读的帧数
+  std::vector<uint8_t> packed_;      // 载荷读取缓冲
+  std::vector<uint8_t> silence_;     // 一帧静音
+};
+
+#endif  // GATED_PCM_H
@@ -0,0 +1,39 @@
+#ifndef HUGE_BUFFER_H
+#define HUGE_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// 预分配的大块内存：优先使用大页（MAP_HUGETLB），不可用时退回普通匿名映射
+// 并建议内核使用透明大页；可选锁定到物理内存，分配时即完成预缺页，
+// 保证实时线程访问时不会再触发缺页或分配。
+class HugeBuffer {
+ public:
+  HugeBuffer();
+  ~HugeBuffer();
+
+  HugeBuffer(HugeBuffer&& other) noexcept;
+  HugeBuffer& operator=(HugeBuffer&& other) noexcept;
+  HugeBuffer(const HugeBuffer&) = delete;
+  HugeBuffer& operator=(const HugeBuffer&) = delete;
+
+  // 分配至少 bytes 字节；lock 为 true 时尝试 mlock（失败只告警）
+  bool Allocate(size_t bytes, bool use_hugepages, bool lock);
+
+  // 释放内存
+  void Release();
+
+  uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+  bool IsHugePages() const { return huge_; }
+  bool IsLocked() const { return locked_; }
+
+ private:
+  uint8_t* data_;
+  size_t size_;     // 可用字节数（请求值）
+  size_t mapped_;   // 实际映射字节数（按页对齐）
+  bool huge_;
+  bool locked_;
+};
+
+#endif  // HUGE_BUFFER_H
@@ -0,0 +1,86 @@
+#ifndef LIMITER_NODE_H
+#define LIMITER_NODE_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "dsp_chain.h"
+
+// 前瞻砖墙限幅器（各通道联动，所有通道共用一个增益）。
+//
+// 检测 -> 所需增益 -> 前瞻窗口内滑动最小值（单调队列，O(1)）-> 长度为 attack 的滑动平均
+// -> 指数释放。音频延迟 lookahead 后再乘以增益，滑动平均的窗口落在最小值保持区间内，
+// 因此峰值到达时增益恰好降到所需值，输出不超过 ceiling。
+//
+// true_peak 开启时检测器做 4 倍过采样插值（每相 8 阶窗函数 sinc），捕捉样本之间的峰值；
+// 关闭时只看样本峰值（降级时使用），两种模式的延迟相同。
+// 延迟通过 GetLatencyFrames 报告给宿主。
+class LimiterNode : public DspNode {
+ public:
+  struct Config {
+    double lookahead_ms = 1.5;  // 前瞻时间，限定在 0.5 ~ 5 ms
+    double attack_ms = 1.5;     // 增益下降的过渡时间，不超过 lookahead_ms
+    double release_ms = 50.0;   // 增益恢复的时间常数
+    double ceiling_db = -1.0;   // 输出上限（dBFS；true_peak 时为 dBTP）
+    bool true_peak = true;
+  };
+
+  LimiterNode();
+  explicit LimiterNode(const Config& config);
+
+  const char* GetName() const override { return "limiter"; }
+  bool Prepare(int sample_rate, int channels, size_t max_frames) override;
+  void Process(float* samples, size_t frames) override;
+  void Reset() override;
+
+  size_t GetLatencyFrames() const override { return delay_frames_; }
+  // 前瞻、平滑窗口与释放包络衰减到 -100 dB 所需的帧数
+  size_t GetWarmupFrames() const override;
+
+  // 控制线程可随时修改
+  void SetCeilingDb(double ceiling_db);
+  void SetTruePeak(bool enabled) { true_peak_.store(enabled, std::memory_order_relaxed); }
+  bool IsTruePeak() const { return true_peak_.load(std::memory_order_relaxed); }
+
+  // 最近一块的最大增益衰减（dB，>= 0）
+  double GetGainReductionDb() const { return reduction_db_.load(std::memory_order_relaxed); }
+
+ private:
+  static constexpr int kTaps = 8;    // 每相插值阶数（与 true_peak::kTaps 一致）
+  static constexpr int kPhases = 4;  // 过采样倍数
+
+  Config config_;
+  std::atomic<float> ceiling_;
+  std::atomic<bool> true_peak_;
+  std::atomic<double> reduction_db_{0.0};
+
+  size_t hold_frames_ = 1;   // 前瞻窗口
+  size_t attack_frames_ = 1; // 平滑窗口
+  size_t delay_frames_ = 0;  // 音频总延迟
+  double release_coef_ = 0.0;
+  float phase_coef_[kPhases][kTaps] = {};
+
+  // 检测器历史：kTaps 帧，双份存放以便取连续窗口
+  std::vector<float> history_;
+  size_t history_pos_ = 0;
+  std::vector<float> tp_acc_;
+
+  // 滑动最小值的单调队列（环形，容量 hold_frames_ + 1）
+  std::vector<float> min_value_;
+  std::vector<uint64_t> min_index_;
+  size_t min_head_ = 0;
+  size_t min_size_ = 0;
+  uint64_t frame_index_ = 0;
+
+  // 滑动平均
+  std::vector<float> box_;
+  size_t box_pos_ = 0;
+  double box_sum_ = 0.0;
+
+  double envelope_ = 1.0;
+  std::vector<float> gains_;  // 当前块逐帧增益
+  std::vector<float> delay_;  // [延迟中的 delay_frames_ 帧][当前块]
+};
+
+#endif  // LIMITER_NODE_H
@@ -0,0 +1,137 @@
+#ifndef METER_TAP_H
+#define METER_TAP_H
+
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "dsp_chain.h"
+#include "fft.h"
+#include "spsc_queue.h"
+
+// 电平表的一次快照（读者侧持有，ReadSnapshot 负责填充）
+struct MeterSnapshot {
+  struct Channel {
+    float peak_db = 0.0f;       // 上次发布以来的样本峰值（dBFS）
+    float rms_db = 0.0f;        // RMS（指数平均，dBFS）
+    float true_peak_db = 0.0f;  // 上次发布以来的 4 倍过采样峰值（dBTP）
+  };
+
+  uint64_t sequence = 0;          // 发布序号，未变化说明没有新数据
+  float momentary_lufs = 0.0f;    // EBU R128 瞬时响度（400 ms）
+  float short_term_lufs = 0.0f;   // EBU R128 短期响度（3 s）
+  std::vector<Channel> channels;
+  size_t bins = 0;                // 每通道频谱点数（fft_size / 2 + 1）
+  double bin_hz = 0.0;            // 频谱分辨率
+  std::vector<float> spectrum_db; // [通道][频点]，dBFS（正弦满量程为 0 dB）
+  uint64_t dropped_blocks = 0;    // 分析线程跟不上而丢弃的块数
+};
+
+// 电平表分接点：插在处理链中，只读不改音频。
+//
+// 音频线程（Process）只做两件事：用 SIMD 计算本块各通道的峰值与平方和，
+// 把原始块拷入预分配的槽位并经无锁 SPSC 队列交给分析线程。没有空闲槽位时直接丢弃该块，
+// 开销与读者数量、分析线程进度都无关。
+//
+// 分析线程（非实时）计算 K 加权响度（ITU-R BS.1770 / EBU R128 瞬时与短期）、
+// true peak 与各通道 Hann 窗 FFT 频谱，按固定间隔通过 seqlock 发布快照。
+// 任意数量的读者（界面、导出器）可随时调用 ReadSnapshot，不会阻塞写者，也不会影响音频线程。
+class MeterTap : public DspNode {
+ public:
+  struct Config {
+    size_t fft_size = 2048;           // 频谱 FFT 点数（2 的幂）
+    int publish_ms = 50;              // 快照发布间隔
+    double buffer_seconds = 1.0;      // 音频线程与分析线程之间可缓冲的音频时长
+    double rms_window_ms = 300.0;     // RMS 平均的时间常数
+    double spectrum_smoothing = 0.5;  // 频谱功率的指数平均系数（0 为不平均）
+  };
+
+  MeterTap();
+  explicit MeterTap(const Config& config);
+  ~MeterTap() override;
+
+  const char* GetName() const override { return "meter"; }
+  // 须在 Start 之前调用
+  bool Prepare(int sample_rate, int channels, size_t max_frames) override;
+  void Process(float* samples, size_t frames) override;
+  // 静音块也要计入响度与频谱
+  bool RunsWhenInactive() const override { return true; }
+
+  // 启动/停止分析线程
+  bool Start();
+  void Stop();
+
+  // 任意线程：读取最近一次发布的快照，尚未发布或写者持续占用时返回 false
+  bool ReadSnapshot(MeterSnapshot* out) const;
+
+  uint64_t GetDroppedBlocks() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  // 音频线程 -> 分析线程的一块
+  struct Block {
+    std::vector<float> samples;
+    std::vector<float> peak;
+    std::vector<float> sum_sq;
+    size_t frames = 0;
+  };
+
+  // 二阶节（直接 II 型转置），每通道独立状态
+  struct Biquad {
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    std::vector<double> z1, z2;
+  };
+
+  void AnalysisLoop();
+  void Analyze(const Block& block);
+  void Publish();
+
+  Config config_;
+
+  // 槽位池：free_ 由分析线程归还，filled_ 由音频线程提交
+  std::vector<Block> blocks_;
+  std::unique_ptr<SpscQueue<uint32_t>> free_;
+  std::unique_ptr<SpscQueue<uint32_t>> filled_;
+  std::atomic<uint64_t> dropped_{0};
+
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+
+  // ---- 以下仅分析线程访问 ----
+  std::vector<float> peak_;       // 发布间隔内的样本峰值
+  std::vector<float> true_peak_;  // 发布间隔内的 true peak
+  std::vector<double> mean_sq_;   // RMS 的指数平均
+  std::vector<float> tp_history_; // 每通道插值窗口，双份存放
+  size_t tp_pos_ = 0;
+  float tp_coef_[4][8] = {};     // 4 相 x 8 阶插值系数（见 src/true_peak.h）
+
+  Biquad shelf_;     // K 加权第一级：高频搁架
+  Biquad highpass_;  // K 加权第二级：RLB 高通
+  std::vector<double> weights_;     // 各通道响度权重（LFE 为 0，环绕为 1.41）
+  std::vector<double> block_sq_;    // 当前 100 ms 子块的加权平方和
+  size_t block_frames_ = 0;         // 子块长度
+  size_t block_fill_ = 0;
+  std::vector<double> loudness_power_;  // 最近 30 个子块的功率（短期窗口 3 s）
+  size_t loudness_pos_ = 0;
+  size_t loudness_count_ = 0;
+
+  std::unique_ptr<dsp::Fft> fft_;
+  std::vector<float> window_;
+  double window_gain_ = 1.0;         // 窗函数系数和，用于把幅度归一化到满量程正弦
+  std::vector<float> spec_history_;  // [通道][fft_size] 最近的样本（环形）
+  size_t spec_pos_ = 0;
+  std::vector<std::complex<float>> fft_buf_;
+  std::vector<double> spec_power_;   // [通道][频点] 平均后的功率
+
+  // ---- seqlock 发布区 ----
+  // 布局：[瞬时, 短期] [峰值, RMS, true peak] x 通道 [频谱] x 通道
+  size_t bins_ = 0;
+  std::unique_ptr<std::atomic<float>[]> published_;
+  size_t published_size_ = 0;
+  std::atomic<uint32_t> seq_{0};
+};
+
+#endif  // METER_TAP_H
@@ -0,0 +1,169 @@
+#ifndef PERIOD_BROADCAST_H
+#define PERIOD_BROADCAST_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 单写多读的周期广播缓冲：一路采集同时喂给录音、实时处理、分析等多个消费者。
+//
+// - 写端（采集线程）从预分配块池中取空闲块，直接把 ReadFrame 读进去再发布，
+//   整个过程没有内存分配，也不会等待任何读者；
+// - 每个读者持有独立游标，按引用计数借用共享块（零拷贝），用完归还；
+// - 读者落后超过 depth 个周期即判定为慢消费者，按策略跳到最旧的可用周期
+//   （kSkipForward）或被直接摘除（kDrop）。
+//
+// 块池大小固定为 depth + max_readers + 1，每个读者同时最多持有一个块，
+// 因此内存与拷贝开销不随读者数量增长。
+class PeriodBroadcast {
+ public:
+  // 慢消费者处理策略
+  enum class SlowReaderPolicy {
+    kSkipForward,  // 跳过已被覆盖的周期，从最旧的可用周期继续
+    kDrop,         // 摘除该读者，之后的 Read 均返回 kDropped
+  };
+
+  // Read 的结果
+  enum class ReadStatus {
+    kOk,       // 取到下一个周期
+    kSkipped,  // 取到周期，但之前有周期因落后被跳过
+    kTimeout,  // 超时内没有新数据
+    kDropped,  // 读者因落后已被摘除
+    kClosed,   // 广播已关闭且数据已读完
+  };
+
+  // 读者借用的只读周期块，析构或 Release 时归还引用
+  class Block {
+   public:
+    Block() = default;
+    ~Block() { Release(); }
+    Block(Block&& other) noexcept;
+    Block& operator=(Block&& other) noexcept;
+    Block(const Block&) = delete;
+    Block& operator=(const Block&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t bytes() const { return bytes_; }
+    int frames() const { return frames_; }
+    uint64_t seq() const { return seq_; }  // 周期序号（从 0 开始）
+    bool valid() const { return owner_ != nullptr; }
+
+    // 提前归还块
+    void Release();
+
+   private:
+    friend class PeriodBroadcast;
+
+    PeriodBroadcast* owner_ = nullptr;
+    uint32_t index_ = 0;
+    const uint8_t* data_ = nullptr;
+    size_t bytes_ = 0;
+    int frames_ = 0;
+    uint64_t seq_ = 0;
+  };
+
+  // block_bytes: 单个周期块的最大字节数
+  // depth:       保留的历史周期数（读者最多可落后的周期数）
+  // max_readers: 最大读者数
+  PeriodBroadcast(size_t block_bytes, size_t depth, size_t max_readers);
+  ~PeriodBroadcast();
+
+  PeriodBroadcast(const PeriodBroadcast&) = delete;
+  PeriodBroadcast& operator=(const PeriodBroadcast&) = delete;
+
+  // ---------- 写端（仅限单个线程调用） ----------
+
+  // 取得一个空闲块的写指针；块池耗尽（读者长时间占用块）时返回 nullptr，
+  // 本周期应直接丢弃
+  uint8_t* BeginWrite();
+
+  // 发布 BeginWrite 取得的块
+  void CommitWrite(int frames, size_t bytes);
+
+  // 放弃 BeginWrite 取得的块（例如 ReadFrame 失败）
+  void AbortWrite();
+
+  // 拷贝入口：等价于 BeginWrite + memcpy + CommitWrite
+  bool Publish(const uint8_t* data, int frames, size_t bytes);
+
+  // 关闭广播，唤醒所有等待中的读者
+  void Close();
+
+  // ---------- 读端 ----------
+
+  // 注册读者，从下一个发布的周期开始读取；读者已满时返回 -1
+  int AddReader(SlowReaderPolicy policy);
+
+  // 注销读者（调用前须归还该读者持有的块）
+  void RemoveReader(int reader);
+
+  // 读取下一个周期。每个读者只能由一个线程读取。
+  // timeout_ms < 0 表示一直等待
+  ReadStatus Read(int reader, Block* out, int timeout_ms);
+
+  // 读者当前落后的周期数
+  uint64_t GetLag(int reader) const;
+
+  // 读者累计跳过的周期数
+  uint64_t GetSkippedPeriods(int reader) const;
+
+  // 获取属性与统计
+  size_t GetBlockBytes() const { return block_bytes_; }
+  size_t GetDepth() const { return depth_; }
+  size_t GetMaxReaders() const { return max_readers_; }
+  uint64_t GetPublished() const { return published_.load(std::memory_order_acquire); }
+  uint64_t GetDroppedWrites() const { return dropped_writes_.load(std::memory_order_relaxed); }
+
+ private:
+  // 块状态：高 32 位为代号（周期序号 + 1 的低 32 位），低 32 位为引用计数。
+  // 环槽本身持有一个引用；引用计数归零的块可以被写端回收。
+  struct alignas(64) BlockState {
+    std::atomic<uint64_t> tag{0};
+    int frames = 0;
+    size_t bytes = 0;
+  };
+
+  struct alignas(64) ReaderState {
+    std::atomic<bool> in_use{false};
+    std::atomic<bool> dropped{false};
+    SlowReaderPolicy policy = SlowReaderPolicy::kSkipForward;
+    std::atomic<uint64_t> cursor{0};
+    std::atomic<uint64_t> skipped{0};
+  };
+
+  static uint64_t Generation(uint64_t seq) { return (seq + 1) & 0xffffffffu; }
+
+  bool TryAcquire(uint32_t index, uint64_t seq);
+  void ReleaseBlock(uint32_t index);
+  uint8_t* BlockData(uint32_t index) { return storage_.data() + index * stride_; }
+  bool WaitForData(uint64_t cursor, int timeout_ms);
+  void WakeReaders();
+
+  size_t block_bytes_;
+  size_t stride_;
+  size_t depth_;
+  size_t max_readers_;
+  size_t pool_size_;
+
+  std::vector<uint8_t> storage_;                  // 全部块的连续存储
+  std::unique_ptr<BlockState[]> blocks_;          // 块状态
+  std::unique_ptr<std::atomic<uint32_t>[]> slots_;  // 环槽 -> 块索引
+  std::unique_ptr<ReaderState[]> readers_;
+
+  // 写端私有状态
+  uint32_t pending_;
+  bool has_pending_;
+  size_t next_scan_;
+
+  alignas(64) std::atomic<uint64_t> published_{0};  // 已发布的周期数
+  std::atomic<uint64_t> dropped_writes_{0};
+  std::atomic<bool> closed_{false};
+
+  // futex 等待字与等待者计数：没有读者等待时写端不进入内核
+  alignas(64) std::atomic<uint32_t> futex_word_{0};
+  std::atomic<int> waiters_{0};
+};
+
+#endif  // PERIOD_BROADCAST_H
@@ -0,0 +1,150 @@
+#ifndef PERIOD_POOL_H
+#define PERIOD_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "huge_buffer.h"
+#include "spsc_queue.h"
+
+// 固定大小的周期块分配器：采集、处理、输出各级之间传递块的所有权，而不是拷贝字节。
+//
+// - Init 在设备 Open 之后按协商得到的周期大小与帧字节数（通道数 × 采样字节数）一次性分配，
+//   全部块放在一块 HugeBuffer 中（优先大页、锁定并预缺页），通道数多时 TLB 未命中更少；
+// - 空闲块挂在无锁空闲栈上（Treiber 栈，栈顶带 32 位代号防 ABA），任意线程都可以取用与归还；
+// - Block 是块的独占句柄，只能移动，析构时自动归还；
+// - 跨线程传递用 PeriodQueue（单生产者单消费者，队列里只存块下标）。
+//
+// 稳态下取块、传递、归还都只是几次原子操作，没有内存分配、没有加锁、没有额外拷贝。
+// 块池耗尽时 Acquire 返回空句柄，调用方应丢弃本周期而不是等待。
+class PeriodPool {
+ public:
+  // 块的独占句柄，析构或 Release 时归还块池
+  class Block {
+   public:
+    Block() = default;
+    ~Block() { Release(); }
+    Block(Block&& other) noexcept;
+    Block& operator=(Block&& other) noexcept;
+    Block(const Block&) = delete;
+    Block& operator=(const Block&) = delete;
+
+    uint8_t* data() const { return data_; }
+    size_t capacity_frames() const;
+    size_t capacity_bytes() const;
+    // 块中有效的帧数，随所有权一起传递
+    size_t frames() const;
+    void set_frames(size_t frames);
+    bool valid() const { return owner_ != nullptr; }
+
+    // 提前归还块
+    void Release();
+
+   private:
+    friend class PeriodPool;
+    friend class PeriodQueue;
+
+    PeriodPool* owner_ = nullptr;
+    uint32_t index_ = 0;
+    uint8_t* data_ = nullptr;
+  };
+
+  PeriodPool();
+  ~PeriodPool();
+
+  PeriodPool(const PeriodPool&) = delete;
+  PeriodPool& operator=(const PeriodPool&) = delete;
+
+  // 分配 block_count 个块，每块 block_frames 帧、每帧 frame_bytes 字节。
+  // 只能在没有块被借出时调用（通常在设备 Open 之后调用一次）
+  bool Init(size_t block_frames, size_t frame_bytes, size_t block_count,
+            bool use_hugepages = true, bool lock = true);
+
+  // 取一个空闲块；块池耗尽时返回空句柄（并计入 GetExhaustedCount）
+  Block Acquire();
+
+  // 获取属性与统计
+  size_t GetBlockFrames() const { return block_frames_; }
+  size_t GetBlockBytes() const { return block_bytes_; }
+  size_t GetBlockCount() const { return block_count_; }
+  size_t GetFreeCount() const { return free_count_.load(std::memory_order_relaxed); }  // 近似值
+  uint64_t GetExhaustedCount() const { return exhausted_.load(std::memory_order_relaxed); }
+  bool IsHugePages() const { return storage_.IsHugePages(); }
+  bool IsLocked() const { return storage_.IsLocked(); }
+
+ private:
+  friend class PeriodQueue;
+
+  static constexpr uint32_t kNil = 0xffffffffu;
+
+  // 块头与块数据分开存放：数据区按缓存行对齐、连续排列
+  struct alignas(64) BlockHeader {
+    std::atomic<uint32_t> next{kNil};  // 空闲栈中的下一个块
+    size_t frames = 0;
+  };
+
+  uint32_t Pop();
+  void Push(uint32_t index);
+  // 把已出栈的块下标包装为句柄 / 放弃句柄的所有权并返回下标（PeriodQueue 使用）
+  Block Adopt(uint32_t index);
+  static uint32_t Detach(Block* block);
+  uint8_t* BlockData(uint32_t index) { return storage_.data() + index * stride_; }
+
+  size_t block_frames_;
+  size_t frame_bytes_;
+  size_t block_bytes_;
+  size_t stride_;
+  size_t block_count_;
+
+  HugeBuffer storage_;                         // 全部块的连续存储
+  std::unique_ptr<BlockHeader[]> headers_;
+
+  // 栈顶：高 32 位为代号（每次出入栈加一），低 32 位为块下标（kNil 为空）
+  alignas(64) std::atomic<uint64_t> head_{kNil};
+  std::atomic<size_t> free_count_{0};
+  std::atomic<uint64_t> exhausted_{0};
+};
+
+// 在两个线程之间传递块所有权的单生产者单消费者队列，消费者可阻塞等待（futex 唤醒）。
+// 生产者 Push 之后不再持有块；没有消费者等待时 Push 不进入内核。
+class PeriodQueue {
+ public:
+  // capacity 不应小于块池中的块数，这样 Push 永远不会失败
+  PeriodQueue(PeriodPool* pool, size_t capacity);
+  ~PeriodQueue();
+
+  PeriodQueue(const PeriodQueue&) = delete;
+  PeriodQueue& operator=(const PeriodQueue&) = delete;
+
+  // 生产者：交出块的所有权；队列已满时块留在 *block 中并返回 false
+  bool Push(PeriodPool::Block* block);
+
+  // 消费者：非阻塞取块
+  bool TryPop(PeriodPool::Block* out);
+
+  // 消费者：阻塞直到取到块；Close 之后且队列已空时返回 false。timeout_ms < 0 表示一直等待，
+  // 超时同样返回 false
+  bool Pop(PeriodPool::Block* out, int timeout_ms = -1);
+
+  // 关闭队列，唤醒等待中的消费者（已入队的块仍可取出）
+  void Close();
+  bool IsClosed() const { return closed_.load(std::memory_order_acquire); }
+
+  // 队列中的块数（近似值，任意线程）
+  size_t SizeApprox() const { return queue_.SizeApprox(); }
+
+ private:
+  void Wake();
+
+  PeriodPool* pool_;
+  SpscQueue<uint32_t> queue_;
+  std::atomic<bool> closed_{false};
+
+  // futex 等待字与等待者计数
+  alignas(64) std::atomic<uint32_t> futex_word_{0};
+  std::atomic<int> waiters_{0};
+};
+
+#endif  // PERIOD_POOL_H
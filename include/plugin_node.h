@@ -0,0 +1,114 @@
+#ifndef PLUGIN_NODE_H
+#define PLUGIN_NODE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arp_plugin.h"
+#include "dsp_chain.h"
+#include "spsc_queue.h"
+
+// 可热替换的插件槽：处理链中的一个节点，运行时通过 dlopen 装入 arp_plugin.h 描述的处理模块。
+//
+// Load 只是排队，立即返回。后台线程负责 dlopen、create 与 prepare（可能很慢，比如加载大模型），
+// 准备好的实例通过一个原子指针交给音频线程。音频线程在下一个块边界取走它，
+// 与旧实例做 crossfade_ms 的线性交叉淡化，之后把旧实例放入退役队列。
+// 后台线程销毁退役实例，并在最后一个实例释放后 dlclose。
+// 音频线程全程只做原子交换与无锁入队，不分配内存，不做系统调用。
+//
+// 槽为空（尚未加载或已 Unload）时原样直通。
+class PluginNode : public DspNode {
+ public:
+  struct Config {
+    double crossfade_ms = 10.0;  // 新旧实例交叉淡化时长，0 为直接切换
+  };
+
+  PluginNode();
+  explicit PluginNode(const Config& config);
+  ~PluginNode() override;
+
+  const char* GetName() const override { return "plugin"; }
+  bool Prepare(int sample_rate, int channels, size_t max_frames) override;
+  void Process(float* samples, size_t frames) override;
+  void Reset() override;
+
+  // 控制线程：请求加载插件并在准备好之后替换当前实例（须在 Prepare 之后调用）
+  bool Load(const std::string& path, const std::string& config = "");
+  // 控制线程：请求卸载（淡出到直通）
+  bool Unload();
+
+  // 控制线程：当前生效的插件名（直通时为空串）、最近一次加载失败的原因
+  std::string GetActiveName() const;
+  std::string GetLastError() const;
+  uint64_t GetSwapCount() const { return swaps_.load(std::memory_order_relaxed); }
+
+ private:
+  // dlopen 得到的库，被它的所有实例共享，最后一个实例销毁后 dlclose
+  struct Module {
+    ~Module();
+    void* handle = nullptr;
+    const arp_plugin_descriptor* descriptor = nullptr;
+  };
+
+  // descriptor 为空的实例表示直通
+  struct Instance {
+    std::shared_ptr<Module> module;
+    const arp_plugin_descriptor* descriptor = nullptr;
+    void* handle = nullptr;
+    uint64_t id = 0;
+  };
+
+  struct Request {
+    bool unload = false;
+    std::string path;
+    std::string config;
+  };
+
+  static void RunInstance(Instance* instance, float* samples, size_t frames);
+  void Retire(Instance* instance);
+
+  // 后台线程
+  bool EnsureWorker();
+  void WorkerLoop();
+  Instance* CreateInstance(const Request& request);
+  void DestroyInstance(Instance* instance);
+  void DrainRetired();
+
+  const Config config_;
+  size_t fade_frames_ = 0;
+
+  // ---- 音频线程 ----
+  Instance* active_ = nullptr;
+  Instance* fading_ = nullptr;  // 交叉淡化中的旧实例（可能为 nullptr，表示直通）
+  bool crossfading_ = false;
+  size_t fade_pos_ = 0;
+  Instance* retire_hold_ = nullptr;  // 退役队列满时暂存，下一块重试
+  std::vector<float> dry_;           // 旧实例的处理缓冲
+
+  // ---- 线程间交接 ----
+  std::atomic<Instance*> pending_{nullptr};  // 后台线程 -> 音频线程
+  SpscQueue<Instance*> retired_;             // 音频线程 -> 后台线程
+  std::atomic<uint64_t> active_id_{0};
+  std::atomic<uint64_t> swaps_{0};
+
+  // ---- 后台线程与控制线程 ----
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Request> requests_;
+  std::map<uint64_t, std::string> names_;  // 存活实例的插件名
+  std::string last_error_;
+  uint64_t next_id_ = 1;
+  bool stop_ = false;
+  std::thread worker_;
+};
+
+#endif  // PLUGIN_NODE_H
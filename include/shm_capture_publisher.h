@@ -0,0 +1,86 @@
+#ifndef SHM_CAPTURE_PUBLISHER_H
+#define SHM_CAPTURE_PUBLISHER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <alsa/asoundlib.h>
+
+namespace shm_capture {
+struct ShmCaptureHeader;
+struct ShmSlotHeader;
+struct ShmWaitState;
+}  // namespace shm_capture
+
+// 把本进程的采集数据发布到 memfd 共享内存环，供其他本地进程零拷贝读取。
+//
+// hw: 设备只能被打开一次，dsnoop 又额外增加延迟；这里由持有 AlsaCapture 的进程
+// 独占设备，把每个周期直接读入共享槽位。订阅端连接 UNIX 套接字后通过
+// SCM_RIGHTS 拿到只读的 memfd，映射后按序读取，以 futex 等待新周期。
+// 发布端从不等待订阅端：落后的订阅端自行跳过被覆盖的周期。
+// 无法取得只读描述符时 Open 失败，可写的 memfd 永远不会发给订阅端；
+// 没有订阅端在等待时发布不做 futex 唤醒系统调用。
+class ShmCapturePublisher {
+ public:
+  ShmCapturePublisher(const std::string& socket_path,
+                      int sample_rate,
+                      int channels,
+                      snd_pcm_format_t format);
+  ~ShmCapturePublisher();
+
+  ShmCapturePublisher(const ShmCapturePublisher&) = delete;
+  ShmCapturePublisher& operator=(const ShmCapturePublisher&) = delete;
+
+  // 创建共享内存环并开始监听。period_bytes 为单个周期的最大字节数
+  bool Open(size_t period_bytes, size_t slot_count);
+
+  // 关闭：通知订阅端结束，停止监听并释放共享内存
+  void Close();
+
+  // 取得下一个槽位的写指针，可直接作为 ReadFrame 的目标缓冲
+  uint8_t* BeginWrite();
+
+  // 发布 BeginWrite 写入的数据
+  void CommitWrite(int frames, size_t bytes);
+
+  // 拷贝入口：等价于 BeginWrite + memcpy + CommitWrite
+  bool Publish(const uint8_t* data, int frames, size_t bytes);
+
+  // 获取属性与统计
+  bool IsOpened() const { return header_ != nullptr; }
+  std::string GetSocketPath() const { return socket_path_; }
+  size_t GetSlotBytes() const { return slot_bytes_; }
+  uint64_t GetPublished() const;
+  int GetServedSubscribers() const { return served_.load(std::memory_order_relaxed); }
+
+ private:
+  void AcceptLoop();
+  bool SendMemfd(int client_fd);
+  shm_capture::ShmSlotHeader* Slot(uint64_t seq) const;
+
+  std::string socket_path_;
+  int sample_rate_;
+  int channels_;
+  snd_pcm_format_t format_;
+
+  int memfd_;
+  int readonly_fd_;  // 发给订阅端的只读描述符
+  int wait_fd_;      // 等待计数页（订阅端可写）
+  int listen_fd_;
+  size_t map_size_;
+  size_t slot_bytes_;
+  size_t slot_count_;
+  size_t slot_stride_;
+  uint8_t* base_;
+  shm_capture::ShmCaptureHeader* header_;
+  shm_capture::ShmWaitState* wait_;
+
+  bool writing_;
+  std::thread accept_thread_;
+  std::atomic<bool> accepting_{false};
+  std::atomic<int> served_{0};
+};
+
+#endif  // SHM_CAPTURE_PUBLISHER_H
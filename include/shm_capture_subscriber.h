@@ -0,0 +1,77 @@
+#ifndef SHM_CAPTURE_SUBSCRIBER_H
+#define SHM_CAPTURE_SUBSCRIBER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace shm_capture {
+struct ShmCaptureHeader;
+struct ShmSlotHeader;
+struct ShmWaitState;
+}  // namespace shm_capture
+
+// 共享采集的订阅端（客户端库，不依赖 ALSA）。
+//
+// 连接发布端的 UNIX 套接字取得只读 memfd 并映射，之后直接在共享内存中读取周期，
+// 不做任何拷贝。由于发布端从不等待，读完一个周期后应调用 Validate 确认
+// 该槽位在读取期间没有被覆盖。
+class ShmCaptureSubscriber {
+ public:
+  // 共享内存中的一个周期（指针指向只读映射）
+  struct Period {
+    const uint8_t* data = nullptr;
+    size_t bytes = 0;
+    int frames = 0;
+    uint64_t seq = 0;
+    int64_t timestamp_ns = 0;  // 发布时刻（CLOCK_MONOTONIC）
+  };
+
+  enum class ReadStatus {
+    kOk,       // 取到下一个周期
+    kSkipped,  // 取到周期，但之前有周期因落后被跳过
+    kTimeout,  // 超时内没有新数据
+    kClosed,   // 发布端已关闭
+  };
+
+  explicit ShmCaptureSubscriber(const std::string& socket_path);
+  ~ShmCaptureSubscriber();
+
+  ShmCaptureSubscriber(const ShmCaptureSubscriber&) = delete;
+  ShmCaptureSubscriber& operator=(const ShmCaptureSubscriber&) = delete;
+
+  // 连接发布端并映射共享内存，从下一个发布的周期开始读取
+  bool Open();
+
+  // 解除映射
+  void Close();
+
+  // 取得下一个周期；timeout_ms < 0 表示一直等待
+  ReadStatus Acquire(Period* out, int timeout_ms);
+
+  // 检查周期数据在读取期间是否仍然有效（未被发布端覆盖）
+  bool Validate(const Period& period) const;
+
+  // 获取流属性与统计
+  bool IsOpened() const { return header_ != nullptr; }
+  int GetSampleRate() const;
+  int GetChannels() const;
+  int GetFormat() const;  // snd_pcm_format_t 的数值
+  int GetBytesPerFrame() const;
+  uint64_t GetLag() const;
+  uint64_t GetSkippedPeriods() const { return skipped_; }
+
+ private:
+  const shm_capture::ShmSlotHeader* Slot(uint64_t seq) const;
+  void Wait(uint32_t observed, int timeout_ms) const;
+
+  std::string socket_path_;
+  const uint8_t* base_;
+  size_t map_size_;
+  const shm_capture::ShmCaptureHeader* header_;
+  shm_capture::ShmWaitState* wait_;  // 可写的等待计数页
+  uint64_t cursor_;
+  uint64_t skipped_;
+};
+
+#endif  // SHM_CAPTURE_SUBSCRIBER_H
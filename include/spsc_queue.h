@@ -0,0 +1,67 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// 单生产者单消费者无锁有界队列。
+//
+// 生产者只写 tail_、消费者只写 head_，两者分处不同缓存行；
+// 各自缓存对方的游标，只有在看起来已满/已空时才重新读取对方的原子变量，
+// 稳态下每次入队/出队只有一次跨核的缓存行传递。
+// 容量向上取整为 2 的幂。T 应为可平凡拷贝的小对象（例如缓冲区下标）。
+template <typename T>
+class SpscQueue {
+ public:
+  explicit SpscQueue(size_t capacity) {
+    size_t cap = 1;
+    while (cap < capacity) cap <<= 1;
+    buf_.resize(cap);
+    mask_ = cap - 1;
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  size_t GetCapacity() const { return mask_ + 1; }
+
+  // 生产者：队列已满时返回 false
+  bool TryPush(const T& value) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ > mask_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail - cached_head_ > mask_) return false;
+    }
+    buf_[tail & mask_] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // 消费者：队列为空时返回 false
+  bool TryPop(T* out) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == cached_tail_) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head == cached_tail_) return false;
+    }
+    *out = buf_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // 近似元素个数（任意线程，仅供统计）
+  size_t SizeApprox() const {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+  }
+
+ private:
+  alignas(64) std::atomic<size_t> head_{0};  // 消费者写
+  size_t cached_tail_ = 0;                   // 消费者缓存的 tail_
+  alignas(64) std::atomic<size_t> tail_{0};  // 生产者写
+  size_t cached_head_ = 0;                   // 生产者缓存的 head_
+  alignas(64) std::vector<T> buf_;
+  size_t mask_ = 0;
+};
+
+#endif  // SPSC_QUEUE_H
@@ -0,0 +1,100 @@
+#ifndef VAD_H
+#define VAD_H
+
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "dsp_kernels.h"
+#include "fft.h"
+
+// 逐通道的活动检测（VAD / 静音检测），在采集路径上按块运行。
+//
+// 每块每通道：
+//   1. 能量：SIMD 计算块 RMS。低于 threshold_db 直接判为静音，高于 loud_db 直接判为活动；
+//   2. 两者之间须同时满足：高出噪声底 snr_db，且块末 fft_size 帧的频谱平坦度
+//      （几何均值 / 算术均值）不超过 max_flatness —— 宽带噪声（风扇、底噪）约 0.5 以上，语音与乐音通常低于 0.2。
+//      只有落在这一区间且超出噪声底的通道才做 FFT，静音通道的开销只有一次 SIMD 求和；
+//   3. 噪声底：下降立即跟随，上升只在判为静音的块上按 noise_rise_db_per_s 进行，
+//      持续的有效信号不会被噪声底追上；
+//   4. 拖尾：通道转为静音后再保持 hangover_ms 的活动，避免切掉字尾与混响。
+//
+// 下游据此跳过静音块的重处理（DspChain::Process 的 active 参数），
+// 录音可把静音存成间隙标记（GatedPcmWriter）。
+//
+// 构造时分配全部内存；Process 不分配、不加锁，可在音频线程中调用。
+class VoiceActivityDetector {
+ public:
+  struct Config {
+    double threshold_db = -60.0;       // 绝对门限（dBFS）：低于此值一律视为静音
+    double snr_db = 9.0;               // 高于噪声底多少 dB 才算活动
+    double loud_db = -30.0;            // 高于此电平时不看频谱平坦度
+    double max_flatness = 0.35;        // 频谱平坦度不超过此值才算活动
+    double hangover_ms = 300.0;        // 活动结束后的拖尾
+    double noise_rise_db_per_s = 3.0;  // 噪声底的上升速度
+    size_t fft_size = 256;             // 平坦度分析的 FFT 点数（2 的幂）
+  };
+
+  VoiceActivityDetector(int sample_rate, int channels);
+  VoiceActivityDetector(int sample_rate, int channels, const Config& config);
+
+  VoiceActivityDetector(const VoiceActivityDetector&) = delete;
+  VoiceActivityDetector& operator=(const VoiceActivityDetector&) = delete;
+
+  // 分析一块交错 float，更新各通道标志；返回是否有任一通道活动
+  bool Process(const float* samples, size_t frames);
+
+  // 交错 PCM 入口：按内核转换到内部缓冲后分析，超过 4096 帧的块分段处理，结果取各段之并
+  bool ProcessInterleaved(const dsp::KernelSet& kernels, const uint8_t* pcm, size_t frames);
+
+  // 清空噪声底与拖尾，所有通道回到静音
+  void Reset();
+
+  // 最近一块的结果（调用 Process 的线程读取）
+  bool IsActive(int channel) const { return (mask_[channel >> 3] >> (channel & 7)) & 1; }
+  bool IsAnyActive() const { return any_active_; }
+  // 活动位图：第 c 通道为 mask[c / 8] 的第 c % 8 位
+  const uint8_t* GetActiveMask() const { return mask_.data(); }
+  size_t GetMaskBytes() const { return mask_.size(); }
+  int GetChannels() const { return channels_; }
+
+  // 统计（任意线程）：分析过的帧数、至少一个通道活动的帧数、通道活动帧数之和
+  uint64_t GetTotalFrames() const { return total_frames_.load(std::memory_order_relaxed); }
+  uint64_t GetActiveFrames() const { return active_frames_.load(std::memory_order_relaxed); }
+  uint64_t GetActiveChannelFrames() const {
+    return active_channel_frames_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  bool Analyze(const float* samples, size_t frames);
+  float SpectralFlatness(const float* samples, size_t frames, int channel);
+
+  const int sample_rate_;
+  const int channels_;
+  const Config config_;
+
+  std::vector<float> peak_;       // 块统计（SIMD 累计）
+  std::vector<float> sum_sq_;
+  std::vector<double> noise_db_;  // 各通道噪声底
+  std::vector<size_t> hangover_;  // 各通道剩余拖尾帧数
+  size_t hangover_frames_ = 0;
+  std::vector<uint8_t> mask_;
+  std::vector<uint8_t> segment_mask_;  // 分段处理时单段的结果
+  bool any_active_ = false;
+
+  dsp::Fft fft_;
+  std::vector<float> window_;
+  std::vector<std::complex<float>> fft_buf_;
+
+  // ProcessInterleaved 的转换缓冲
+  static constexpr size_t kMaxFrames = 4096;
+  std::vector<float> scratch_;
+
+  std::atomic<uint64_t> total_frames_{0};
+  std::atomic<uint64_t> active_frames_{0};
+  std::atomic<uint64_t> active_channel_frames_{0};
+};
+
+#endif  // VAD_H
@@ -1,8 +1,11 @@
 #include "alsa_capture.h"
 
 #include <alsa/asoundlib.h>
+#include <algorithm>
 #include <iostream>
 
+#include "frame_traits.h"
+
 // 构造函数：初始化音频采集设备
 AlsaCapture::AlsaCapture(const std::string& device, int sample_rate, int channels)
     : device_(device),           // 设备名称（如 "hw:0", "default"）
@@ -11,7 +14,14 @@ AlsaCapture::AlsaCapture(const std::string& device, int sample_rate, int channel
       handle_(nullptr),          // ALSA设备句柄
       buffer_size_(0),           // 缓冲区大小（帧数）
       period_size_(0),           // 周期大小（帧数）
-      format_(SND_PCM_FORMAT_S16_LE)  // 默认使用16位有符号小端格式
+      format_(SND_PCM_FORMAT_S16_LE),  // 默认使用16位有符号小端格式
+      frame_bytes_(0),           // 每帧字节数（Open 时确定）
+      requested_period_(0),      // 周期大小（0 = 按缓冲区大小的 1/4）
+      requested_periods_(0),     // 周期数
+      access_(SND_PCM_ACCESS_RW_INTERLEAVED),
+      wakeup_periods_(0),        // 0 = 每周期唤醒
+      avail_min_(0),
+      xrun_count_(0)
 {
     std::cout << "初始化音频采集设备: " << device << std::endl;
     std::cout << "采样率: " << sample_rate << "Hz" << std::endl;
@@ -45,8 +55,8 @@ bool AlsaCapture::Open() {
         return false;
     }
 
-    // 设置访问类型为交错模式（左右声道数据交错存储）
-    err = snd_pcm_hw_params_set_access(handle_, params, SND_PCM_ACCESS_RW_INTERLEAVED);
+    // 设置访问类型为交错模式（左右声道数据交错存储），读写或 mmap
+    err = snd_pcm_hw_params_set_access(handle_, params, access_);
     if (err < 0) {
         std::cerr << "无法设置访问类型: " << snd_strerror(err) << std::endl;
         return false;
@@ -74,23 +84,44 @@ bool AlsaCapture::Open() {
         return false;
     }
 
-    // 计算并设置缓冲区大小（100ms的缓冲）
-    snd_pcm_uframes_t buffer_size = rate / 10;  // 100ms = 0.1秒
-    err = snd_pcm_hw_params_set_buffer_size_near(handle_, params, &buffer_size);
-    if (err < 0) {
-        std::cerr << "无法设置缓冲区大小: " << snd_strerror(err) << std::endl;
-        return false;
-    }
-    buffer_size_ = buffer_size;
+    if (requested_period_ > 0) {
+        // 按请求的周期大小与周期数设置，缓冲区大小由二者决定
+        snd_pcm_uframes_t period_size = requested_period_;
+        err = snd_pcm_hw_params_set_period_size_near(handle_, params, &period_size, 0);
+        if (err < 0) {
+            std::cerr << "无法设置周期大小: " << snd_strerror(err) << std::endl;
+            return false;
+        }
+        unsigned int periods = requested_periods_;
+        err = snd_pcm_hw_params_set_periods_near(handle_, params, &periods, 0);
+        if (err < 0) {
+            std::cerr << "无法设置周期数: " << snd_strerror(err) << std::endl;
+            return false;
+        }
+        period_size_ = period_size;
+        buffer_size_ = period_size * periods;
+    } else {
+        // 计算并设置缓冲区大小（100ms的缓冲）
+        snd_pcm_uframes_t buffer_size = rate / 10;  // 100ms = 0.1秒
+        err = snd_pcm_hw_params_set_buffer_size_near(handle_, params, &buffer_size);
+        if (err < 0) {
+            std::cerr << "无法设置缓冲区大小: " << snd_strerror(err) << std::endl;
+            return false;
+        }
+        buffer_size_ = buffer_size;
 
-    // 计算并设置周期大小（缓冲区大小的1/4）
-    snd_pcm_uframes_t period_size = buffer_size / 4;
-    err = snd_pcm_hw_params_set_period_size_near(handle_, params, &period_size, 0);
-    if (err < 0) {
-        std::cerr << "无法设置周期大小: " << snd_strerror(err) << std::endl;
-        return false;
+        // 计算并设置周期大小（缓冲区大小的1/4）
+        snd_pcm_uframes_t period_size = buffer_size / 4;
+        err = snd_pcm_hw_params_set_period_size_near(handle_, params, &period_size, 0);
+        if (err < 0) {
+            std::cerr << "无法设置周期大小: " << snd_strerror(err) << std::endl;
+            return false;
+        }
+        period_size_ = period_size;
     }
-    period_size_ = period_size;
+
+    // 帧大小在格式与通道数确定后只计算一次，读写热路径直接使用
+    frame_bytes_ = static_cast<size_t>(channels_) * GetBytesPerSample();
 
     // 应用硬件参数
     err = snd_pcm_hw_params(handle_, params);
@@ -98,6 +129,38 @@ bool AlsaCapture::Open() {
         std::cerr << "无法应用硬件参数: " << snd_strerror(err) << std::endl;
         return false;
     }
+    // 以硬件最终确定的值为准
+    snd_pcm_hw_params_get_buffer_size(params, &buffer_size_);
+    snd_pcm_hw_params_get_period_size(params, &period_size_, nullptr);
+
+    // 唤醒阈值：默认一个周期；吞吐模式为多个周期，但至少留一个周期的余量防止溢出。
+    // 缓冲区不足两个周期时留不出余量（buffer - period 还会回绕），退回每周期唤醒
+    avail_min_ = period_size_;
+    if (wakeup_periods_ > 1 && buffer_size_ < 2 * period_size_) {
+        std::cerr << "缓冲区只有 " << buffer_size_ << " 帧，不足两个周期，吞吐模式退回每周期唤醒"
+                  << std::endl;
+    } else if (wakeup_periods_ > 1) {
+        avail_min_ = std::min<snd_pcm_uframes_t>(period_size_ * wakeup_periods_,
+                                                 buffer_size_ - period_size_);
+
+        snd_pcm_sw_params_t* sw_params;
+        snd_pcm_sw_params_alloca(&sw_params);
+        err = snd_pcm_sw_params_current(handle_, sw_params);
+        if (err < 0) {
+            std::cerr << "无法获取软件参数: " << snd_strerror(err) << std::endl;
+            return false;
+        }
+        err = snd_pcm_sw_params_set_avail_min(handle_, sw_params, avail_min_);
+        if (err < 0) {
+            std::cerr << "无法设置唤醒阈值: " << snd_strerror(err) << std::endl;
+            return false;
+        }
+        err = snd_pcm_sw_params(handle_, sw_params);
+        if (err < 0) {
+            std::cerr << "无法应用软件参数: " << snd_strerror(err) << std::endl;
+            return false;
+        }
+    }
 
     // 准备设备开始采集
     err = snd_pcm_prepare(handle_);
@@ -109,6 +172,9 @@ bool AlsaCapture::Open() {
     std::cout << "音频设备已打开" << std::endl;
     std::cout << "缓冲区大小: " << buffer_size_ << " 帧" << std::endl;
     std::cout << "周期大小: " << period_size_ << " 帧" << std::endl;
+    if (avail_min_ > period_size_) {
+        std::cout << "吞吐模式: 每 " << avail_min_ << " 帧唤醒一次" << std::endl;
+    }
     return true;
 }
 
@@ -129,63 +195,74 @@ bool AlsaCapture::ReadFrame(uint8_t* buffer, size_t buffer_size, int* frames_rea
         return false;
     }
 
-    // 计算可读取的帧数
-    int frames = buffer_size / (channels_ * GetBytesPerSample());
-    if (frames > period_size_) {
+    // 计算可读取的帧数：低延迟模式每次最多一个周期，吞吐模式读走所有可用帧
+    const bool batch = avail_min_ > period_size_;
+    snd_pcm_uframes_t frames = buffer_size / frame_bytes_;
+    if (!batch && frames > period_size_) {
         frames = period_size_;
     }
 
     // 读取音频数据
-    int err = snd_pcm_readi(handle_, buffer, frames);
+    const bool mmap = access_ == SND_PCM_ACCESS_MMAP_INTERLEAVED;
+    snd_pcm_sframes_t err = batch ? ReadAvailable(buffer, frames)
+                          : mmap  ? snd_pcm_mmap_readi(handle_, buffer, frames)
+                                  : snd_pcm_readi(handle_, buffer, frames);
     if (err < 0) {
-        err = snd_pcm_recover(handle_, err, 0);
-        if (err < 0) {
-            std::cerr << "ReadFrame recover failed: " << snd_strerror(err) << std::endl;
+        if (err == -EPIPE) {
+            ++xrun_count_;
+        }
+        int rc = snd_pcm_recover(handle_, static_cast<int>(err), 0);
+        if (rc < 0) {
+            std::cerr << "ReadFrame recover failed: " << snd_strerror(rc) << std::endl;
             return false;
         }
         // recover succeeded, read again
-        err = snd_pcm_readi(handle_, buffer, frames);
+        err = batch ? ReadAvailable(buffer, frames)
+            : mmap  ? snd_pcm_mmap_readi(handle_, buffer, frames)
+                    : snd_pcm_readi(handle_, buffer, frames);
         if (err < 0) {
-            std::cerr << "ReadFrame after recover failed: " << snd_strerror(err) << std::endl;
-            return false;
-        }
-    }
-        } else {
-            std::cerr << "读取错误: " << snd_strerror(err) << std::endl;
+            std::cerr << "ReadFrame after recover failed: " << snd_strerror(static_cast<int>(err)) << std::endl;
             return false;
         }
     }
 
     // 设置实际读取的帧数
-    *frames_read = err;
+    *frames_read = static_cast<int>(err);
     return true;
 }
 
+// 吞吐模式：一次 poll 等到 avail_min，再用一次 readi（mmap 时为一段 mmap 拷贝）读走全部可用帧。
+// 阻塞的 snd_pcm_readi 读大块时会在内核里按 avail_min 多次唤醒直到读满，这里只读已经到达的数据。
+snd_pcm_sframes_t AlsaCapture::ReadAvailable(uint8_t* buffer, snd_pcm_uframes_t max_frames) {
+    // 采集流要显式启动（readi 会自动启动，poll 不会）
+    if (snd_pcm_state(handle_) == SND_PCM_STATE_PREPARED) {
+        int err = snd_pcm_start(handle_);
+        if (err < 0) return err;
+    }
+
+    snd_pcm_sframes_t avail = snd_pcm_avail_update(handle_);
+    if (avail < 0) return avail;
+    if (static_cast<snd_pcm_uframes_t>(avail) < avail_min_) {
+        int err = snd_pcm_wait(handle_, -1);
+        if (err < 0) return err;
+        avail = snd_pcm_avail_update(handle_);
+        if (avail < 0) return avail;
+    }
+
+    const snd_pcm_uframes_t frames = std::min(static_cast<snd_pcm_uframes_t>(avail), max_frames);
+    if (frames == 0) return 0;
+    return access_ == SND_PCM_ACCESS_MMAP_INTERLEAVED ? snd_pcm_mmap_readi(handle_, buffer, frames)
+                                                      : snd_pcm_readi(handle_, buffer, frames);
+}
+
 // 获取每个采样的字节数
 int AlsaCapture::GetBytesPerSample() const {
-    switch (format_) {
-        case SND_PCM_FORMAT_S8:      return 1;  // 8位有符号
-        case SND_PCM_FORMAT_U8:      return 1;  // 8位无符号
-        case SND_PCM_FORMAT_S16_LE:  return 2;  // 16位有符号小端
-        case SND_PCM_FORMAT_S16_BE:  return 2;  // 16位有符号大端
-        case SND_PCM_FORMAT_U16_LE:  return 2;  // 16位无符号小端
-        case SND_PCM_FORMAT_U16_BE:  return 2;  // 16位无符号大端
-        case SND_PCM_FORMAT_S24_LE:  return 3;  // 24位有符号小端
-        case SND_PCM_FORMAT_S24_BE:  return 3;  // 24位有符号大端
-        case SND_PCM_FORMAT_U24_LE:  return 3;  // 24位无符号小端
-        case SND_PCM_FORMAT_U24_BE:  return 3;  // 24位无符号大端
-        case SND_PCM_FORMAT_S32_LE:  return 4;  // 32位有符号小端
-        case SND_PCM_FORMAT_S32_BE:  return 4;  // 32位有符号大端
-        case SND_PCM_FORMAT_U32_LE:  return 4;  // 32位无符号小端
-        case SND_PCM_FORMAT_U32_BE:  return 4;  // 32位无符号大端
-        case SND_PCM_FORMAT_FLOAT_LE: return 4;  // 32位浮点小端
-        case SND_PCM_FORMAT_FLOAT_BE: return 4;  // 32位浮点大端
-        case SND_PCM_FORMAT_FLOAT64_LE: return 8;  // 64位浮点小端
-        case SND_PCM_FORMAT_FLOAT64_BE: return 8;  // 64位浮点大端
-        default:
-            std::cerr << "不支持的音频格式" << std::endl;
-            return 2;  // 默认返回2字节
+    const int bytes = FormatBytesPerSample(format_);
+    if (bytes == 0) {
+        std::cerr << "不支持的音频格式" << std::endl;
+        return 2;  // 默认返回2字节
     }
+    return bytes;
 }
 
 // 获取当前缓冲区大小
@@ -198,6 +275,11 @@ snd_pcm_uframes_t AlsaCapture::GetPeriodSize() const {
     return period_size_;
 }
 
+// 获取当前采样格式
+snd_pcm_format_t AlsaCapture::GetFormat() const {
+    return format_;
+}
+
 bool AlsaCapture::SetFormat(snd_pcm_format_t format)
 {
     if (handle_) {
@@ -208,6 +290,45 @@ bool AlsaCapture::SetFormat(snd_pcm_format_t format)
     return true;
 }
 
+bool AlsaCapture::SetPeriodConfig(snd_pcm_uframes_t period_frames, unsigned int periods)
+{
+    if (handle_) {
+        std::cerr << "设备已打开，无法更改周期配置" << std::endl;
+        return false;
+    }
+    if (period_frames > 0 && periods < 2) {
+        std::cerr << "周期数至少为 2" << std::endl;
+        return false;
+    }
+    requested_period_ = period_frames;
+    requested_periods_ = periods;
+    return true;
+}
+
+bool AlsaCapture::SetAccess(snd_pcm_access_t access)
+{
+    if (handle_) {
+        std::cerr << "设备已打开，无法更改访问方式" << std::endl;
+        return false;
+    }
+    if (access != SND_PCM_ACCESS_RW_INTERLEAVED && access != SND_PCM_ACCESS_MMAP_INTERLEAVED) {
+        std::cerr << "仅支持交错读写或交错 mmap 访问" << std::endl;
+        return false;
+    }
+    access_ = access;
+    return true;
+}
+
+bool AlsaCapture::SetWakeupPeriods(unsigned int periods)
+{
+    if (handle_) {
+        std::cerr << "设备已打开，无法更改唤醒间隔" << std::endl;
+        return false;
+    }
+    wakeup_periods_ = periods;
+    return true;
+}
+
 // 在 alsa_capture.cpp 中添加 Recover 函数的实现
 bool AlsaCapture::Recover() {
     if (!handle_) {
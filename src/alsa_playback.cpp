@@ -1,15 +1,25 @@
 #include "alsa_playback.h"
 
 #include <alsa/asoundlib.h>
+#include <algorithm>
 #include <iostream>
 
+#include "frame_traits.h"
+
 // 构造函数
 AlsaPlayback::AlsaPlayback(const std::string& device, int sample_rate, int channels)
     : device_(device),
       sample_rate_(sample_rate),
       channels_(channels),
       handle_(nullptr),
-      format_(SND_PCM_FORMAT_S16_LE)  // 默认使用16位有符号小端格式
+      format_(SND_PCM_FORMAT_S16_LE),  // 默认使用16位有符号小端格式
+      frame_bytes_(0),
+      requested_period_(0),
+      requested_periods_(0),
+      access_(SND_PCM_ACCESS_RW_INTERLEAVED),
+      wakeup_periods_(0),
+      buffer_size_(0),
+      period_size_(0)
 {
 }
 
@@ -68,18 +78,20 @@ bool AlsaPlayback::WriteFrame(const uint8_t* buffer, size_t buffer_size, int* fr
     }
     
     // 计算可以写入的最大帧数
-    int max_frames = buffer_size / (channels_ * GetBytesPerSample());
+    snd_pcm_uframes_t max_frames = buffer_size / frame_bytes_;
     
     // 写入音频帧
-    int result = snd_pcm_writei(handle_, buffer, max_frames);
+    snd_pcm_sframes_t result = (access_ == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+                                   ? snd_pcm_mmap_writei(handle_, buffer, max_frames)
+                                   : snd_pcm_writei(handle_, buffer, max_frames);
     
     if (result < 0) {
-        std::cerr << "写入音频帧失败: " << snd_strerror(result) << std::endl;
+        std::cerr << "写入音频帧失败: " << snd_strerror(static_cast<int>(result)) << std::endl;
         return false;
     }
     
     if (frames_written) {
-        *frames_written = result;
+        *frames_written = static_cast<int>(result);
     }
     
     return true;
@@ -113,8 +125,8 @@ bool AlsaPlayback::SetParams() {
         return false;
     }
     
-    // 设置访问类型
-    err = snd_pcm_hw_params_set_access(handle_, params, SND_PCM_ACCESS_RW_INTERLEAVED);
+    // 设置访问类型（交错读写或交错 mmap）
+    err = snd_pcm_hw_params_set_access(handle_, params, access_);
     if (err < 0) {
         std::cerr << "无法设置音频访问类型: " << snd_strerror(err) << std::endl;
         return false;
@@ -145,20 +157,70 @@ bool AlsaPlayback::SetParams() {
     // 更新实际采样率
     sample_rate_ = rate;
     
-    // 设置缓冲区大小
-    snd_pcm_uframes_t buffer_size = sample_rate_ / 10;  // 100ms缓冲
-    err = snd_pcm_hw_params_set_buffer_size_near(handle_, params, &buffer_size);
-    if (err < 0) {
-        std::cerr << "无法设置音频缓冲区大小: " << snd_strerror(err) << std::endl;
-        return false;
+    if (requested_period_ > 0) {
+        // 按请求的周期大小与周期数设置
+        snd_pcm_uframes_t period_size = requested_period_;
+        err = snd_pcm_hw_params_set_period_size_near(handle_, params, &period_size, 0);
+        if (err < 0) {
+            std::cerr << "无法设置音频周期大小: " << snd_strerror(err) << std::endl;
+            return false;
+        }
+        unsigned int periods = requested_periods_;
+        err = snd_pcm_hw_params_set_periods_near(handle_, params, &periods, 0);
+        if (err < 0) {
+            std::cerr << "无法设置音频周期数: " << snd_strerror(err) << std::endl;
+            return false;
+        }
+    } else {
+        // 设置缓冲区大小
+        snd_pcm_uframes_t buffer_size = sample_rate_ / 10;  // 100ms缓冲
+        err = snd_pcm_hw_params_set_buffer_size_near(handle_, params, &buffer_size);
+        if (err < 0) {
+            std::cerr << "无法设置音频缓冲区大小: " << snd_strerror(err) << std::endl;
+            return false;
+        }
     }
     
+    // 帧大小只在这里计算一次，WriteFrame 直接使用
+    frame_bytes_ = static_cast<size_t>(channels_) * GetBytesPerSample();
+    
     // 应用参数
     err = snd_pcm_hw_params(handle_, params);
     if (err < 0) {
         std::cerr << "无法设置音频参数: " << snd_strerror(err) << std::endl;
         return false;
     }
+    snd_pcm_hw_params_get_buffer_size(params, &buffer_size_);
+    snd_pcm_hw_params_get_period_size(params, &period_size_, nullptr);
+    
+    // 吞吐模式：多个周期唤醒一次，至少留一个周期的数据防止欠载。
+    // 缓冲区不足两个周期时留不出余量（buffer - period 还会回绕），退回每周期唤醒
+    if (wakeup_periods_ > 1 && buffer_size_ < 2 * period_size_) {
+        std::cerr << "缓冲区只有 " << buffer_size_ << " 帧，不足两个周期，吞吐模式退回每周期唤醒"
+                  << std::endl;
+    } else if (wakeup_periods_ > 1) {
+        const snd_pcm_uframes_t avail_min = std::min<snd_pcm_uframes_t>(period_size_ * wakeup_periods_,
+                                                                        buffer_size_ - period_size_);
+
+        snd_pcm_sw_params_t* sw_params;
+        snd_pcm_sw_params_alloca(&sw_params);
+        err = snd_pcm_sw_params_current(handle_, sw_params);
+        if (err < 0) {
+            std::cerr << "无法获取音频软件参数: " << snd_strerror(err) << std::endl;
+            return false;
+        }
+        err = snd_pcm_sw_params_set_avail_min(handle_, sw_params, avail_min);
+        if (err < 0) {
+            std::cerr << "无法设置音频唤醒阈值: " << snd_strerror(err) << std::endl;
+            return false;
+        }
+        err = snd_pcm_sw_params(handle_, sw_params);
+        if (err < 0) {
+            std::cerr << "无法应用音频软件参数: " << snd_strerror(err) << std::endl;
+            return false;
+        }
+        std::cout << "吞吐模式: 每 " << avail_min << " 帧唤醒一次" << std::endl;
+    }
     
     std::cout << "音频参数已设置: " << sample_rate_ << "Hz, " 
               << channels_ << "通道, " << format_ << std::endl;
@@ -168,29 +230,12 @@ bool AlsaPlayback::SetParams() {
 
 // 获取字节数
 int AlsaPlayback::GetBytesPerSample() const {
-    switch (format_) {
-        case SND_PCM_FORMAT_S8:      return 1;  // 8位有符号
-        case SND_PCM_FORMAT_U8:      return 1;  // 8位无符号
-        case SND_PCM_FORMAT_S16_LE:  return 2;  // 16位有符号小端
-        case SND_PCM_FORMAT_S16_BE:  return 2;  // 16位有符号大端
-        case SND_PCM_FORMAT_U16_LE:  return 2;  // 16位无符号小端
-        case SND_PCM_FORMAT_U16_BE:  return 2;  // 16位无符号大端
-        case SND_PCM_FORMAT_S24_LE:  return 3;  // 24位有符号小端
-        case SND_PCM_FORMAT_S24_BE:  return 3;  // 24位有符号大端
-        case SND_PCM_FORMAT_U24_LE:  return 3;  // 24位无符号小端
-        case SND_PCM_FORMAT_U24_BE:  return 3;  // 24位无符号大端
-        case SND_PCM_FORMAT_S32_LE:  return 4;  // 32位有符号小端
-        case SND_PCM_FORMAT_S32_BE:  return 4;  // 32位有符号大端
-        case SND_PCM_FORMAT_U32_LE:  return 4;  // 32位无符号小端
-        case SND_PCM_FORMAT_U32_BE:  return 4;  // 32位无符号大端
-        case SND_PCM_FORMAT_FLOAT_LE: return 4;  // 32位浮点小端
-        case SND_PCM_FORMAT_FLOAT_BE: return 4;  // 32位浮点大端
-        case SND_PCM_FORMAT_FLOAT64_LE: return 8;  // 64位浮点小端
-        case SND_PCM_FORMAT_FLOAT64_BE: return 8;  // 64位浮点大端
-        default:
-            std::cerr << "不支持的音频格式" << std::endl;
-            return 2;  // 默认返回2字节
+    const int bytes = FormatBytesPerSample(format_);
+    if (bytes == 0) {
+        std::cerr << "不支持的音频格式" << std::endl;
+        return 2;  // 默认返回2字节
     }
+    return bytes;
 }
 
 // 获取格式
@@ -206,4 +251,43 @@ bool AlsaPlayback::SetFormat(snd_pcm_format_t format) {
     }
     format_ = format;
     return true;
-} 
\ No newline at end of file
+} 
+
+// 设置周期配置
+bool AlsaPlayback::SetPeriodConfig(snd_pcm_uframes_t period_frames, unsigned int periods) {
+    if (handle_) {
+        std::cerr << "设备已打开，无法更改周期配置" << std::endl;
+        return false;
+    }
+    if (period_frames > 0 && periods < 2) {
+        std::cerr << "周期数至少为 2" << std::endl;
+        return false;
+    }
+    requested_period_ = period_frames;
+    requested_periods_ = periods;
+    return true;
+}
+
+// 设置访问方式
+bool AlsaPlayback::SetAccess(snd_pcm_access_t access) {
+    if (handle_) {
+        std::cerr << "设备已打开，无法更改访问方式" << std::endl;
+        return false;
+    }
+    if (access != SND_PCM_ACCESS_RW_INTERLEAVED && access != SND_PCM_ACCESS_MMAP_INTERLEAVED) {
+        std::cerr << "仅支持交错读写或交错 mmap 访问" << std::endl;
+        return false;
+    }
+    access_ = access;
+    return true;
+}
+
+// 设置吞吐模式的唤醒间隔
+bool AlsaPlayback::SetWakeupPeriods(unsigned int periods) {
+    if (handle_) {
+        std::cerr << "设备已打开，无法更改唤醒间隔" << std::endl;
+        return false;
+    }
+    wakeup_periods_ = periods;
+    return true;
+}
@@ -0,0 +1,226 @@
+#include "capture_history.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+// 写盘时与写指针保持的安全距离（容量的 1/kSafetyDivisor），避免拷贝过程中被采集线程追上。
+// 单次 Write 的帧数必须小于这个距离，否则尚未发布的写入可能覆盖正在拷贝的数据
+constexpr uint64_t kSafetyDivisor = 16;
+
+// 每次写盘的块大小
+constexpr size_t kChunkBytes = 256 * 1024;
+
+bool WriteAll(int fd, const uint8_t* data, size_t bytes) {
+    while (bytes > 0) {
+        ssize_t n = ::write(fd, data, bytes);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        bytes -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+}  // namespace
+
+// 构造函数：seconds 为保存的历史时长
+CaptureHistory::CaptureHistory(int sample_rate, int channels, int bytes_per_sample, double seconds)
+    : sample_rate_(sample_rate),
+      channels_(channels),
+      frame_bytes_(static_cast<size_t>(channels) * bytes_per_sample),
+      capacity_frames_(static_cast<uint64_t>(seconds * sample_rate))
+{
+    if (capacity_frames_ == 0) {
+        capacity_frames_ = static_cast<uint64_t>(sample_rate);
+    }
+}
+
+CaptureHistory::~CaptureHistory() {
+    Close();
+}
+
+bool CaptureHistory::Open(bool use_hugepages, bool lock_memory) {
+    if (IsOpened()) {
+        return true;
+    }
+    if (!buffer_.Allocate(capacity_frames_ * frame_bytes_, use_hugepages, lock_memory)) {
+        return false;
+    }
+    total_frames_.store(0, std::memory_order_relaxed);
+    stop_ = false;
+    writer_ = std::thread(&CaptureHistory::WriterLoop, this);
+
+    std::cout << "历史缓冲已分配: " << capacity_frames_ / static_cast<double>(sample_rate_)
+              << " 秒, " << buffer_.size() / (1024 * 1024) << " MB"
+              << (buffer_.IsHugePages() ? " (大页)" : "")
+              << (buffer_.IsLocked() ? " (已锁定)" : "") << std::endl;
+    return true;
+}
+
+void CaptureHistory::Close() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+    buffer_.Release();
+}
+
+void CaptureHistory::Write(const uint8_t* data, int frames) {
+    if (!IsOpened() || frames <= 0) {
+        return;
+    }
+
+    uint64_t total = total_frames_.load(std::memory_order_relaxed);
+    uint64_t n = static_cast<uint64_t>(frames);
+
+    // 一次写入超过总容量时只保留最后 capacity 帧
+    if (n > capacity_frames_) {
+        data += (n - capacity_frames_) * frame_bytes_;
+        total += n - capacity_frames_;
+        n = capacity_frames_;
+    }
+
+    // 分两段写（写指针可能绕回）
+    const uint64_t pos = total % capacity_frames_;
+    const uint64_t first = std::min(n, capacity_frames_ - pos);
+    uint8_t* base = buffer_.data();
+    std::memcpy(base + pos * frame_bytes_, data, first * frame_bytes_);
+    if (n > first) {
+        std::memcpy(base, data + first * frame_bytes_, (n - first) * frame_bytes_);
+    }
+
+    total_frames_.store(total + n, std::memory_order_release);
+}
+
+bool CaptureHistory::RequestSnapshot(double seconds_before, double seconds_after,
+                                     const std::string& path) {
+    if (!IsOpened()) {
+        std::cerr << "历史缓冲未打开" << std::endl;
+        return false;
+    }
+
+    const uint64_t trigger = total_frames_.load(std::memory_order_acquire);
+    const uint64_t before = static_cast<uint64_t>(std::max(0.0, seconds_before) * sample_rate_);
+    const uint64_t after = static_cast<uint64_t>(std::max(0.0, seconds_after) * sample_rate_);
+    const uint64_t oldest = trigger > capacity_frames_ ? trigger - capacity_frames_ : 0;
+
+    SnapshotRequest req;
+    req.start_frame = trigger > before ? trigger - before : 0;
+    if (req.start_frame < oldest) {
+        std::cerr << "快照起点超出历史范围，截取最近 "
+                  << capacity_frames_ / static_cast<double>(sample_rate_) << " 秒" << std::endl;
+        req.start_frame = oldest;
+    }
+    req.end_frame = trigger + after;
+    req.path = path;
+
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        requests_.push_back(req);
+    }
+    cv_.notify_one();
+    return true;
+}
+
+// 后台写盘线程
+void CaptureHistory::WriterLoop() {
+    while (true) {
+        SnapshotRequest req;
+        {
+            std::unique_lock<std::mutex> lk(mu_);
+            cv_.wait(lk, [&]{ return stop_ || !requests_.empty(); });
+            if (requests_.empty()) {
+                break;  // stop_ 且无待写快照
+            }
+            req = requests_.front();
+            requests_.pop_front();
+        }
+        if (SaveSnapshot(req)) {
+            completed_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool CaptureHistory::SaveSnapshot(const SnapshotRequest& req) {
+    int fd = ::open(req.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "无法创建快照文件 " << req.path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    const size_t chunk_frames = std::max<size_t>(1, kChunkBytes / frame_bytes_);
+    const uint64_t window = capacity_frames_ - capacity_frames_ / kSafetyDivisor;
+    std::vector<uint8_t> bounce(chunk_frames * frame_bytes_);
+    const uint8_t* base = buffer_.data();
+
+    uint64_t pos = req.start_frame;
+    uint64_t lost = 0;
+    bool ok = true;
+
+    while (pos < req.end_frame) {
+        // 等待时间窗内的数据采齐（停止时写出已有部分）
+        uint64_t total = total_frames_.load(std::memory_order_acquire);
+        if (total <= pos) {
+            if (stop_) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            continue;
+        }
+
+        // 已被新数据覆盖的部分无法找回
+        const uint64_t oldest = total > window ? total - window : 0;
+        if (pos < oldest) {
+            lost += oldest - pos;
+            pos = oldest;
+            continue;
+        }
+
+        const uint64_t n = std::min<uint64_t>({chunk_frames, req.end_frame - pos, total - pos});
+        const uint64_t rpos = pos % capacity_frames_;
+        const uint64_t first = std::min(n, capacity_frames_ - rpos);
+        std::memcpy(bounce.data(), base + rpos * frame_bytes_, first * frame_bytes_);
+        if (n > first) {
+            std::memcpy(bounce.data() + first * frame_bytes_, base, (n - first) * frame_bytes_);
+        }
+
+        // 拷贝期间被追上则丢弃本块，下一轮按覆盖处理。
+        // Write 先 memcpy 再发布 total_frames_，正在进行的写入已经在覆盖
+        // [after - capacity, after - capacity + n) 的帧，所以与拷贝前使用同一安全距离
+        const uint64_t after = total_frames_.load(std::memory_order_acquire);
+        if (after > window && pos < after - window) {
+            continue;
+        }
+
+        if (!WriteAll(fd, bounce.data(), n * frame_bytes_)) {
+            std::cerr << "写入快照失败 " << req.path << ": " << std::strerror(errno) << std::endl;
+            ok = false;
+            break;
+        }
+        pos += n;
+    }
+
+    ::close(fd);
+    if (lost > 0) {
+        std::cerr << "快照 " << req.path << " 丢失 " << lost << " 帧（超出历史缓冲）" << std::endl;
+    }
+    if (ok) {
+        std::cout << "快照已保存: " << req.path << " ("
+                  << (pos - req.start_frame - lost) / static_cast<double>(sample_rate_)
+                  << " 秒)" << std::endl;
+    }
+    return ok;
+}
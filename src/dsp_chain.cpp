@@ -0,0 +1,100 @@
+#include "dsp_chain.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+void DspChain::AddNode(std::unique_ptr<DspNode> node) {
+    if (node) {
+        nodes_.push_back(std::move(node));
+    }
+}
+
+std::vector<std::unique_ptr<DspNode>> DspChain::TakeNodes() {
+    std::vector<std::unique_ptr<DspNode>> nodes;
+    nodes.swap(nodes_);
+    return nodes;
+}
+
+bool DspChain::Prepare(int sample_rate, int channels, size_t max_frames) {
+    if (sample_rate <= 0 || channels <= 0 || max_frames == 0) {
+        std::cerr << "处理链参数无效" << std::endl;
+        return false;
+    }
+    for (auto& node : nodes_) {
+        if (!node->Prepare(sample_rate, channels, max_frames)) {
+            std::cerr << "处理节点准备失败: " << node->GetName() << std::endl;
+            return false;
+        }
+    }
+    sample_rate_ = sample_rate;
+    channels_ = channels;
+    max_frames_ = max_frames;
+    scratch_.assign(max_frames * channels, 0.0f);
+    return true;
+}
+
+void DspChain::Process(float* samples, size_t frames, bool active) {
+    while (frames > 0) {
+        const size_t n = std::min(frames, max_frames_);
+        RunNodes(samples, n, active);
+        samples += n * channels_;
+        frames -= n;
+    }
+}
+
+void DspChain::ProcessInterleaved(const dsp::KernelSet& kernels, uint8_t* pcm, size_t frames,
+                                  bool active) {
+    while (frames > 0) {
+        const size_t n = std::min(frames, max_frames_);
+        if (active) {
+            kernels.ToFloat(pcm, scratch_.data(), n);
+        }
+        RunNodes(scratch_.data(), n, active);
+        kernels.FromFloat(scratch_.data(), pcm, n);
+        pcm += n * kernels.frame_bytes;
+        frames -= n;
+    }
+}
+
+// 依次运行未被旁路的节点；非活动块输出静音，跳过的节点在下一个活动块前 Reset
+void DspChain::RunNodes(float* samples, size_t frames, bool active) {
+    if (!active) {
+        std::memset(samples, 0, frames * channels_ * sizeof(float));
+    }
+    for (auto& node : nodes_) {
+        if (node->IsBypassed()) {
+            continue;
+        }
+        if (!active && !node->RunsWhenInactive()) {
+            node->reset_pending_.store(true, std::memory_order_relaxed);
+            continue;
+        }
+        if (node->reset_pending_.exchange(false, std::memory_order_relaxed)) {
+            node->Reset();
+        }
+        node->Process(samples, frames);
+    }
+}
+
+void DspChain::Reset() {
+    for (auto& node : nodes_) {
+        node->Reset();
+    }
+}
+
+size_t DspChain::GetWarmupFrames() const {
+    size_t total = 0;
+    for (const auto& node : nodes_) {
+        total += node->GetWarmupFrames();
+    }
+    return total;
+}
+
+size_t DspChain::GetLatencyFrames() const {
+    size_t total = 0;
+    for (const auto& node : nodes_) {
+        total += node->GetLatencyFrames();
+    }
+    return total;
+}
@@ -0,0 +1,94 @@
+#include "dsp_kernels.h"
+
+#include <iostream>
+
+namespace dsp {
+
+namespace {
+
+// 把特化内核适配成统一的函数指针签名（通道数参数被忽略）
+template <snd_pcm_format_t Format, int Channels>
+void ToFloatEntry(const void* in, float* out, size_t frames, int) {
+    ToFloat<Format, Channels>(in, out, frames);
+}
+
+template <snd_pcm_format_t Format, int Channels>
+void FromFloatEntry(const float* in, void* out, size_t frames, int) {
+    FromFloat<Format, Channels>(in, out, frames);
+}
+
+template <snd_pcm_format_t Format, int Channels>
+void ApplyGainEntry(void* samples, size_t frames, int, const float* gains) {
+    ApplyGain<Format, Channels>(samples, frames, gains);
+}
+
+template <snd_pcm_format_t Format, int Channels>
+KernelSet MakeSpecialized() {
+    KernelSet k;
+    k.to_float = &ToFloatEntry<Format, Channels>;
+    k.from_float = &FromFloatEntry<Format, Channels>;
+    k.apply_gain = &ApplyGainEntry<Format, Channels>;
+    k.format = Format;
+    k.channels = Channels;
+    k.frame_bytes = Frame<Format, Channels>::kBytes;
+    k.specialized = true;
+    return k;
+}
+
+template <snd_pcm_format_t Format>
+KernelSet MakeGeneric(int channels) {
+    KernelSet k;
+    k.to_float = &ToFloatGeneric<Format>;
+    k.from_float = &FromFloatGeneric<Format>;
+    k.apply_gain = &ApplyGainGeneric<Format>;
+    k.format = Format;
+    k.channels = channels;
+    k.frame_bytes = sizeof(typename SampleTraits<Format>::Type) * channels;
+    k.specialized = false;
+    return k;
+}
+
+// 某一格式下按通道数选择：1/2/8 通道走特化版本
+template <snd_pcm_format_t Format>
+KernelSet SelectForFormat(int channels) {
+    switch (channels) {
+        case 1: return MakeSpecialized<Format, 1>();
+        case 2: return MakeSpecialized<Format, 2>();
+        case 8: return MakeSpecialized<Format, 8>();
+        default: return MakeGeneric<Format>(channels);
+    }
+}
+
+}  // namespace
+
+bool SelectKernels(snd_pcm_format_t format, int channels, KernelSet* out) {
+    if (channels <= 0) {
+        std::cerr << "无效的通道数: " << channels << std::endl;
+        return false;
+    }
+    switch (format) {
+        case SND_PCM_FORMAT_S16_LE:   *out = SelectForFormat<SND_PCM_FORMAT_S16_LE>(channels); return true;
+        case SND_PCM_FORMAT_S32_LE:   *out = SelectForFormat<SND_PCM_FORMAT_S32_LE>(channels); return true;
+        case SND_PCM_FORMAT_FLOAT_LE: *out = SelectForFormat<SND_PCM_FORMAT_FLOAT_LE>(channels); return true;
+        default:
+            std::cerr << "处理内核不支持的音频格式: " << format << std::endl;
+            return false;
+    }
+}
+
+bool SelectGenericKernels(snd_pcm_format_t format, int channels, KernelSet* out) {
+    if (channels <= 0) {
+        std::cerr << "无效的通道数: " << channels << std::endl;
+        return false;
+    }
+    switch (format) {
+        case SND_PCM_FORMAT_S16_LE:   *out = MakeGeneric<SND_PCM_FORMAT_S16_LE>(channels); return true;
+        case SND_PCM_FORMAT_S32_LE:   *out = MakeGeneric<SND_PCM_FORMAT_S32_LE>(channels); return true;
+        case SND_PCM_FORMAT_FLOAT_LE: *out = MakeGeneric<SND_PCM_FORMAT_FLOAT_LE>(channels); return true;
+        default:
+            std::cerr << "处理内核不支持的音频格式: " << format << std::endl;
+            return false;
+    }
+}
+
+}  // namespace dsp
@@ -0,0 +1,115 @@
+#include "dsp_nodes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// ========== GainNode ==========
+
+void GainNode::Process(float* samples, size_t frames) {
+    const float gain = gain_.load(std::memory_order_relaxed);
+    if (gain == 1.0f) return;
+    const size_t n = frames * channels_;
+    for (size_t i = 0; i < n; ++i) {
+        samples[i] *= gain;
+    }
+}
+
+// ========== BiquadNode ==========
+
+BiquadNode::BiquadNode(Type type, double freq_hz, double q, double gain_db)
+    : type_(type),
+      freq_hz_(freq_hz),
+      q_(q),
+      gain_db_(gain_db)
+{
+}
+
+bool BiquadNode::Prepare(int sample_rate, int channels, size_t max_frames) {
+    DspNode::Prepare(sample_rate, channels, max_frames);
+    if (freq_hz_ <= 0.0 || freq_hz_ >= sample_rate / 2.0 || q_ <= 0.0) {
+        std::cerr << "滤波器参数无效: " << freq_hz_ << "Hz, Q=" << q_ << std::endl;
+        return false;
+    }
+
+    // RBJ cookbook 系数
+    const double w0 = 2.0 * M_PI * freq_hz_ / sample_rate;
+    const double cw = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q_);
+    double b0, b1, b2, a0, a1, a2;
+    switch (type_) {
+        case Type::kLowPass:
+            b0 = (1.0 - cw) / 2.0;
+            b1 = 1.0 - cw;
+            b2 = (1.0 - cw) / 2.0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cw;
+            a2 = 1.0 - alpha;
+            break;
+        case Type::kHighPass:
+            b0 = (1.0 + cw) / 2.0;
+            b1 = -(1.0 + cw);
+            b2 = (1.0 + cw) / 2.0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cw;
+            a2 = 1.0 - alpha;
+            break;
+        case Type::kPeak:
+        default: {
+            const double a = std::pow(10.0, gain_db_ / 40.0);
+            b0 = 1.0 + alpha * a;
+            b1 = -2.0 * cw;
+            b2 = 1.0 - alpha * a;
+            a0 = 1.0 + alpha / a;
+            a1 = -2.0 * cw;
+            a2 = 1.0 - alpha / a;
+            break;
+        }
+    }
+    b0_ = b0 / a0;
+    b1_ = b1 / a0;
+    b2_ = b2 / a0;
+    a1_ = a1 / a0;
+    a2_ = a2 / a0;
+
+    // 由极点半径估算冲激响应衰减到 -100 dB 的长度
+    const double na1 = a1_;
+    const double na2 = a2_;
+    const double disc = na1 * na1 - 4.0 * na2;
+    double radius;
+    if (disc < 0.0) {
+        radius = std::sqrt(na2);
+    } else {
+        const double s = std::sqrt(disc);
+        radius = std::max(std::fabs((-na1 + s) / 2.0), std::fabs((-na1 - s) / 2.0));
+    }
+    warmup_frames_ = (radius > 0.0 && radius < 1.0)
+                         ? static_cast<size_t>(std::ceil(std::log(1e-5) / std::log(radius)))
+                         : 0;
+
+    z1_.assign(channels, 0.0);
+    z2_.assign(channels, 0.0);
+    return true;
+}
+
+void BiquadNode::Process(float* samples, size_t frames) {
+    for (int c = 0; c < channels_; ++c) {
+        double z1 = z1_[c];
+        double z2 = z2_[c];
+        float* s = samples + c;
+        for (size_t i = 0; i < frames; ++i) {
+            const double x = s[i * channels_];
+            const double y = b0_ * x + z1;
+            z1 = b1_ * x - a1_ * y + z2;
+            z2 = b2_ * x - a2_ * y;
+            s[i * channels_] = static_cast<float>(y);
+        }
+        z1_[c] = z1;
+        z2_[c] = z2;
+    }
+}
+
+void BiquadNode::Reset() {
+    std::fill(z1_.begin(), z1_.end(), 0.0);
+    std::fill(z2_.begin(), z2_.end(), 0.0);
+}
@@ -0,0 +1,256 @@
+#include "dsp_pipeline.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "futex_ops.h"
+
+namespace {
+
+constexpr double kLoadSmoothing = 0.1;  // 负载滑动平均系数
+
+}  // namespace
+
+// ========== Handoff ==========
+
+void DspPipeline::Handoff::Push(uint32_t slot) {
+    // 队列容量不小于周期缓冲数，不会满
+    queue.TryPush(slot);
+    futex::Notify(&seq, waiters);
+}
+
+bool DspPipeline::Handoff::Pop(uint32_t* slot, const std::atomic<bool>& running) {
+    while (true) {
+        if (queue.TryPop(slot)) return true;
+        if (!running.load(std::memory_order_acquire)) return false;
+
+        // 先取 futex 字再复查队列：复查之后的入队必然改变 seq，等待会立即返回
+        const uint32_t observed = seq.load(std::memory_order_seq_cst);
+        if (queue.TryPop(slot)) return true;
+        futex::WaitAsWaiter(&seq, observed, &waiters);
+    }
+}
+
+void DspPipeline::Handoff::WakeAll() {
+    futex::NotifyAll(&seq);
+}
+
+// ========== DspPipeline ==========
+
+DspPipeline::DspPipeline(size_t stage_count) {
+    stage_count = std::max<size_t>(stage_count, 1);
+    for (size_t i = 0; i < stage_count; ++i) {
+        stages_.push_back(std::make_unique<Stage>());
+    }
+}
+
+DspPipeline::~DspPipeline() {
+    Stop();
+}
+
+bool DspPipeline::Partition(DspChain* chain, const std::vector<size_t>& split) {
+    auto nodes = chain->TakeNodes();
+    std::vector<size_t> counts = split;
+    if (counts.empty()) {
+        // 平均分配，余数给前面几级
+        const size_t n = stages_.size();
+        for (size_t i = 0; i < n; ++i) {
+            counts.push_back(nodes.size() / n + (i < nodes.size() % n ? 1 : 0));
+        }
+    }
+    size_t total = 0;
+    for (size_t c : counts) total += c;
+    if (counts.size() != stages_.size() || total != nodes.size()) {
+        std::cerr << "流水线分级与节点数不符: " << nodes.size() << " 个节点, "
+                  << stages_.size() << " 级" << std::endl;
+        for (auto& node : nodes) chain->AddNode(std::move(node));
+        return false;
+    }
+
+    size_t next = 0;
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        for (size_t k = 0; k < counts[i]; ++k) {
+            stages_[i]->chain.AddNode(std::move(nodes[next++]));
+        }
+    }
+    return true;
+}
+
+bool DspPipeline::Prepare(const dsp::KernelSet& kernels, int sample_rate, int channels,
+                          size_t max_frames, size_t latency_periods) {
+    if (running_) {
+        std::cerr << "流水线运行中，无法重新准备" << std::endl;
+        return false;
+    }
+    if (kernels.channels != channels) {
+        std::cerr << "流水线内核通道数与处理通道数不符" << std::endl;
+        return false;
+    }
+    for (auto& stage : stages_) {
+        if (!stage->chain.Prepare(sample_rate, channels, max_frames)) {
+            return false;
+        }
+    }
+
+    kernels_ = kernels;
+    sample_rate_ = sample_rate;
+    channels_ = channels;
+    max_frames_ = max_frames;
+    latency_periods_ = latency_periods > 0 ? latency_periods : stages_.size();
+
+    // 在途的周期最多 latency_periods + 1 个
+    const size_t slot_count = latency_periods_ + 1;
+    slots_.assign(slot_count, Slot());
+    for (auto& slot : slots_) {
+        slot.samples.assign(max_frames * channels, 0.0f);
+    }
+
+    handoffs_.clear();
+    for (size_t i = 0; i <= stages_.size(); ++i) {
+        handoffs_.push_back(std::make_unique<Handoff>(slot_count));
+    }
+    return true;
+}
+
+bool DspPipeline::Start(const std::vector<int>& cpus, int rt_priority) {
+    if (running_) return true;
+    if (handoffs_.empty()) {
+        std::cerr << "流水线尚未准备" << std::endl;
+        return false;
+    }
+
+    // 回收上次运行中仍在途的缓冲（Stop 可能与调用方的 Process 并发，只能在这里回收）
+    free_slots_.clear();
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        free_slots_.push_back(static_cast<uint32_t>(slots_.size() - 1 - i));
+    }
+    for (auto& handoff : handoffs_) {
+        uint32_t slot;
+        while (handoff->queue.TryPop(&slot)) {}
+    }
+    in_flight_ = 0;
+
+    const int cpu_count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    running_ = true;
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        // 默认让出 CPU 0（通常承担中断与采集/播放线程）
+        const int cpu = i < cpus.size() ? cpus[i] : static_cast<int>((i + 1) % cpu_count);
+        stages_[i]->thread = std::thread(&DspPipeline::StageLoop, this, i, cpu, rt_priority);
+    }
+    return true;
+}
+
+void DspPipeline::Stop() {
+    if (!running_.exchange(false)) return;
+    for (auto& handoff : handoffs_) {
+        handoff->WakeAll();
+    }
+    for (auto& stage : stages_) {
+        if (stage->thread.joinable()) stage->thread.join();
+    }
+}
+
+size_t DspPipeline::Process(uint8_t* pcm, size_t frames, bool active) {
+    if (!running_.load(std::memory_order_acquire) || free_slots_.empty()) {
+        return 0;
+    }
+    frames = std::min(frames, max_frames_);
+
+    // 送入本周期
+    const uint32_t in = free_slots_.back();
+    free_slots_.pop_back();
+    if (active) {
+        kernels_.ToFloat(pcm, slots_[in].samples.data(), frames);
+    }
+    slots_[in].frames = frames;
+    slots_[in].active = active;
+    handoffs_.front()->Push(in);
+    ++in_flight_;
+
+    // 预热阶段：流水线尚未填满，输出静音
+    if (in_flight_ <= latency_periods_) {
+        std::memset(pcm, 0, frames * kernels_.frame_bytes);
+        return frames;
+    }
+
+    // 取回 latency_periods 个周期之前送入的结果
+    uint32_t out;
+    Handoff& tail = *handoffs_.back();
+    if (!tail.queue.TryPop(&out)) {
+        stalls_.fetch_add(1, std::memory_order_relaxed);
+        if (!tail.Pop(&out, running_)) return 0;
+    }
+    --in_flight_;
+    const size_t out_frames = slots_[out].frames;
+    kernels_.FromFloat(slots_[out].samples.data(), pcm, out_frames);
+    free_slots_.push_back(out);
+    return out_frames;
+}
+
+void DspPipeline::StageLoop(size_t index, int cpu, int rt_priority) {
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+            std::cerr << "[Pipeline] 第 " << index << " 级无法绑定 CPU " << cpu << std::endl;
+        }
+    }
+    if (rt_priority > 0) {
+        sched_param param{};
+        param.sched_priority = rt_priority;
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+            std::cerr << "[Pipeline] 第 " << index << " 级无法设置实时优先级（需要 CAP_SYS_NICE 或 rtprio 限额）"
+                      << std::endl;
+        }
+    }
+
+    Stage& stage = *stages_[index];
+    Handoff& input = *handoffs_[index];
+    Handoff& output = *handoffs_[index + 1];
+    double avg = 0.0;
+    uint32_t slot;
+    while (input.Pop(&slot, running_)) {
+        Slot& s = slots_[slot];
+        const auto t0 = std::chrono::steady_clock::now();
+        stage.chain.Process(s.samples.data(), s.frames, s.active);
+        const double elapsed =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        if (s.frames > 0) {
+            const double load = elapsed * sample_rate_ / static_cast<double>(s.frames);
+            avg += kLoadSmoothing * (load - avg);
+            stage.last_load.store(load, std::memory_order_relaxed);
+            stage.load.store(avg, std::memory_order_relaxed);
+            if (load > stage.peak_load.load(std::memory_order_relaxed)) {
+                stage.peak_load.store(load, std::memory_order_relaxed);
+            }
+        }
+        output.Push(slot);
+    }
+}
+
+double DspPipeline::GetStageLoad(size_t index) const {
+    return stages_[index]->load.load(std::memory_order_relaxed);
+}
+
+double DspPipeline::GetStagePeakLoad(size_t index) const {
+    return stages_[index]->peak_load.load(std::memory_order_relaxed);
+}
+
+double DspPipeline::GetStageLastLoad(size_t index) const {
+    return stages_[index]->last_load.load(std::memory_order_relaxed);
+}
+
+double DspPipeline::GetMaxStageLastLoad() const {
+    double max_load = 0.0;
+    for (const auto& stage : stages_) {
+        max_load = std::max(max_load, stage->last_load.load(std::memory_order_relaxed));
+    }
+    return max_load;
+}
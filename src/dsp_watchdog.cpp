@@ -0,0 +1,82 @@
+#include "dsp_watchdog.h"
+
+#include <algorithm>
+
+DspLoadWatchdog::DspLoadWatchdog(int sample_rate)
+    : DspLoadWatchdog(sample_rate, Config())
+{
+}
+
+DspLoadWatchdog::DspLoadWatchdog(int sample_rate, const Config& config)
+    : sample_rate_(sample_rate),
+      config_(config)
+{
+}
+
+void DspLoadWatchdog::AddLevel(const std::string& name, EngageFn engage) {
+    levels_.push_back(Level{name, std::move(engage)});
+}
+
+void DspLoadWatchdog::EndPeriod(size_t frames) {
+    if (frames == 0 || sample_rate_ <= 0) return;
+
+    const double elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - begin_).count();
+    const double deadline = static_cast<double>(frames) / sample_rate_;
+    Update(elapsed / deadline);
+}
+
+void DspLoadWatchdog::Update(double load) {
+    avg_ += config_.smoothing * (load - avg_);
+    load_.store(avg_, std::memory_order_relaxed);
+    if (load > peak_load_.load(std::memory_order_relaxed)) {
+        peak_load_.store(load, std::memory_order_relaxed);
+    }
+
+    // 单块超时：后续写入必然欠载，立即降级而不等待平均值
+    const bool overrun = load > 1.0;
+    if (overrun) {
+        overruns_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (overrun || avg_ > config_.degrade_threshold) {
+        under_count_ = 0;
+        ++over_count_;
+        // 超时可以跳过计数，但不能跳过上一次降级后的收敛等待（over_count_ 为负），
+        // 否则连续几块超时会一口气降到底
+        if ((overrun && over_count_ >= 0) || over_count_ >= config_.degrade_periods) {
+            StepDown();
+        }
+    } else if (avg_ < config_.recover_threshold) {
+        over_count_ = 0;
+        if (++under_count_ >= config_.recover_periods) {
+            StepUp();
+        }
+    } else {
+        over_count_ = 0;
+        under_count_ = 0;
+    }
+}
+
+void DspLoadWatchdog::StepDown() {
+    const int level = level_.load(std::memory_order_relaxed);
+    if (level >= static_cast<int>(levels_.size())) {
+        over_count_ = 0;  // 已无可降级别
+        return;
+    }
+
+    levels_[level].engage(true);
+    level_.store(level + 1, std::memory_order_relaxed);
+    degrades_.fetch_add(1, std::memory_order_relaxed);
+    // 平均值仍带着降级前的负载，多等 degrade_periods 块让它收敛后再判断下一级
+    over_count_ = -config_.degrade_periods;
+}
+
+void DspLoadWatchdog::StepUp() {
+    under_count_ = 0;
+    const int level = level_.load(std::memory_order_relaxed);
+    if (level <= 0) return;
+
+    levels_[level - 1].engage(false);
+    level_.store(level - 1, std::memory_order_relaxed);
+}
@@ -0,0 +1,75 @@
+#include "fft.h"
+
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+namespace dsp {
+
+Fft::Fft(size_t size)
+    : size_(size)
+{
+    if (!IsPowerOfTwo(size_)) {
+        std::cerr << "FFT 大小必须是 2 的幂: " << size_ << std::endl;
+        size_ = NextPowerOfTwo(size_);
+    }
+
+    twiddle_.resize(size_ / 2);
+    for (size_t k = 0; k < size_ / 2; ++k) {
+        // 用 double 计算后再截断，避免大尺寸时相位累积误差
+        const double phase = -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(size_);
+        twiddle_[k] = std::complex<float>(static_cast<float>(std::cos(phase)),
+                                          static_cast<float>(std::sin(phase)));
+    }
+
+    bitrev_.resize(size_);
+    size_t bits = 0;
+    while ((size_t{1} << bits) < size_) ++bits;
+    for (size_t i = 0; i < size_; ++i) {
+        size_t r = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        bitrev_[i] = r;
+    }
+}
+
+void Fft::Forward(std::complex<float>* data) const {
+    Transform(data, false);
+}
+
+void Fft::Inverse(std::complex<float>* data) const {
+    Transform(data, true);
+    const float scale = 1.0f / static_cast<float>(size_);
+    for (size_t i = 0; i < size_; ++i) {
+        data[i] *= scale;
+    }
+}
+
+void Fft::Transform(std::complex<float>* data, bool inverse) const {
+    for (size_t i = 0; i < size_; ++i) {
+        if (i < bitrev_[i]) {
+            std::swap(data[i], data[bitrev_[i]]);
+        }
+    }
+
+    for (size_t len = 2; len <= size_; len <<= 1) {
+        const size_t half = len / 2;
+        const size_t step = size_ / len;
+        for (size_t start = 0; start < size_; start += len) {
+            for (size_t k = 0; k < half; ++k) {
+                std::complex<float> w = twiddle_[k * step];
+                if (inverse) w = std::conj(w);
+                const std::complex<float> u = data[start + k];
+                const std::complex<float> x = data[start + k + half];
+                // 手写复数乘法：std::complex 的 operator* 要处理 NaN/Inf，会退化为库调用
+                const std::complex<float> v(x.real() * w.real() - x.imag() * w.imag(),
+                                            x.real() * w.imag() + x.imag() * w.real());
+                data[start + k] = u + v;
+                data[start + k + half] = u - v;
+            }
+        }
+    }
+}
+
+}  // namespace dsp
@@ -0,0 +1,67 @@
+#ifndef FUTEX_OPS_H
+#define FUTEX_OPS_H
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+
+// 进程内 futex 等待/唤醒（DspPipeline、PeriodBroadcast、PeriodQueue 共用）。
+// 只在 src/ 内部使用，不属于公共接口。
+//
+// 约定：写端每次发布都把 futex 字加一，读端在等待期间把等待者计数加一。
+// 读端先取 futex 字、再复查条件、最后 Wait；复查之后的发布必然改变 futex 字，内核会立即返回，
+// 因此写端可以在没有等待者时跳过 FUTEX_WAKE 而不会丢失唤醒。
+
+namespace futex {
+
+// futex 字仍等于 expected 时睡眠；timeout 为相对时间，nullptr 表示一直等待
+inline long Wait(std::atomic<uint32_t>* word, uint32_t expected, const timespec* timeout = nullptr) {
+  return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT_PRIVATE,
+                 expected, timeout, nullptr, 0);
+}
+
+inline long WakeAll(std::atomic<uint32_t>* word) {
+  return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE_PRIVATE,
+                 INT_MAX, nullptr, nullptr, 0);
+}
+
+// 读端：登记为等待者后等待 futex 字离开 expected。timeout_ms < 0 表示一直等待。
+// 返回后调用方须重新检查条件（可能是超时或伪唤醒）
+template <typename Counter>
+inline void WaitAsWaiter(std::atomic<uint32_t>* word, uint32_t expected,
+                         std::atomic<Counter>* waiters, int timeout_ms = -1) {
+  timespec ts;
+  const timespec* timeout = nullptr;
+  if (timeout_ms >= 0) {
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000L;
+    timeout = &ts;
+  }
+  waiters->fetch_add(1, std::memory_order_seq_cst);
+  Wait(word, expected, timeout);
+  waiters->fetch_sub(1, std::memory_order_seq_cst);
+}
+
+// 写端：发布之后推进 futex 字，只有存在等待者时才进入内核
+template <typename Counter>
+inline void Notify(std::atomic<uint32_t>* word, const std::atomic<Counter>& waiters) {
+  word->fetch_add(1, std::memory_order_seq_cst);
+  if (waiters.load(std::memory_order_seq_cst) > 0) {
+    WakeAll(word);
+  }
+}
+
+// 关闭/停止：无条件唤醒所有等待者
+inline void NotifyAll(std::atomic<uint32_t>* word) {
+  word->fetch_add(1, std::memory_order_seq_cst);
+  WakeAll(word);
+}
+
+}  // namespace futex
+
+#endif  // FUTEX_OPS_H
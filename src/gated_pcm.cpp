@@ -0,0 +1,254 @@
+#include "gated_pcm.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+#include "frame_traits.h"
+
+namespace {
+
+constexpr char kMagic[4] = {'A', 'R', 'P', 'G'};
+constexpr uint16_t kVersion = 1;
+
+struct FileHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t channels;
+    uint32_t sample_rate;
+    int32_t format;
+    uint16_t bytes_per_sample;
+    uint16_t reserved0;
+    uint32_t reserved1;
+    uint64_t total_frames;
+};
+static_assert(sizeof(FileHeader) == 32, "文件头必须为 32 字节");
+
+constexpr std::streamoff kTotalFramesOffset = offsetof(FileHeader, total_frames);
+
+bool MaskBit(const uint8_t* mask, int channel) {
+    return (mask[channel >> 3] >> (channel & 7)) & 1;
+}
+
+}  // namespace
+
+// ========== GatedPcmWriter ==========
+
+GatedPcmWriter::~GatedPcmWriter() {
+    Close();
+}
+
+bool GatedPcmWriter::Open(const std::string& path, int sample_rate, int channels,
+                          snd_pcm_format_t format) {
+    Close();
+    bytes_per_sample_ = FormatBytesPerSample(format);
+    if (bytes_per_sample_ == 0 || channels <= 0 || channels > 0xFFFF) {
+        std::cerr << "间隙 PCM 参数无效: channels=" << channels << std::endl;
+        return false;
+    }
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) {
+        std::cerr << "无法创建输出文件: " << path << std::endl;
+        return false;
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.channels = static_cast<uint16_t>(channels);
+    header.sample_rate = static_cast<uint32_t>(sample_rate);
+    header.format = static_cast<int32_t>(format);
+    header.bytes_per_sample = static_cast<uint16_t>(bytes_per_sample_);
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    channels_ = channels;
+    mask_bytes_ = (channels + 7) / 8;
+    zero_mask_.assign(mask_bytes_, 0);
+    full_mask_.assign(mask_bytes_, 0);
+    for (int c = 0; c < channels; ++c) {
+        full_mask_[c >> 3] |= static_cast<uint8_t>(1u << (c & 7));
+    }
+    pending_gap_ = 0;
+    total_frames_ = 0;
+    gap_frames_ = 0;
+    bytes_written_ = sizeof(header);
+    return file_.good();
+}
+
+bool GatedPcmWriter::Write(const uint8_t* data, size_t frames, const uint8_t* active_mask) {
+    if (!file_.is_open() || frames == 0) return file_.is_open();
+    total_frames_ += frames;
+
+    int active = channels_;
+    if (active_mask) {
+        active = 0;
+        for (int c = 0; c < channels_; ++c) {
+            active += MaskBit(active_mask, c);
+        }
+    }
+    if (active == 0) {
+        pending_gap_ += frames;
+        gap_frames_ += frames;
+        return true;
+    }
+    if (!FlushGap()) return false;
+
+    // 全部通道活动：原样写出，不重排
+    const size_t bps = static_cast<size_t>(bytes_per_sample_);
+    if (active == channels_) {
+        return WriteRecord(static_cast<uint32_t>(frames), full_mask_.data(), data, frames * channels_ * bps);
+    }
+
+    // 只保留活动通道
+    packed_.resize(frames * active * bps);
+    uint8_t* dst = packed_.data();
+    const size_t frame_bytes = channels_ * bps;
+    for (size_t f = 0; f < frames; ++f) {
+        const uint8_t* src = data + f * frame_bytes;
+        for (int c = 0; c < channels_; ++c) {
+            if (MaskBit(active_mask, c)) {
+                std::memcpy(dst, src + c * bps, bps);
+                dst += bps;
+            }
+        }
+    }
+    return WriteRecord(static_cast<uint32_t>(frames), active_mask, packed_.data(), packed_.size());
+}
+
+bool GatedPcmWriter::FlushGap() {
+    while (pending_gap_ > 0) {
+        const uint32_t frames = static_cast<uint32_t>(std::min<uint64_t>(pending_gap_, UINT32_MAX));
+        if (!WriteRecord(frames, zero_mask_.data(), nullptr, 0)) return false;
+        pending_gap_ -= frames;
+    }
+    return true;
+}
+
+bool GatedPcmWriter::WriteRecord(uint32_t frames, const uint8_t* mask, const uint8_t* payload,
+                                 size_t bytes) {
+    file_.write(reinterpret_cast<const char*>(&frames), sizeof(frames));
+    file_.write(reinterpret_cast<const char*>(mask), mask_bytes_);
+    if (bytes > 0) {
+        file_.write(reinterpret_cast<const char*>(payload), bytes);
+    }
+    bytes_written_ += sizeof(frames) + mask_bytes_ + bytes;
+    if (!file_.good()) {
+        std::cerr << "写入间隙 PCM 文件失败" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool GatedPcmWriter::Close() {
+    if (!file_.is_open()) return true;
+    bool ok = FlushGap();
+    file_.seekp(kTotalFramesOffset);
+    file_.write(reinterpret_cast<const char*>(&total_frames_), sizeof(total_frames_));
+    ok = ok && file_.good();
+    file_.close();
+    return ok;
+}
+
+// ========== GatedPcmReader ==========
+
+bool GatedPcmReader::Open(const std::string& path) {
+    Close();
+    file_.open(path, std::ios::binary);
+    if (!file_.is_open()) {
+        std::cerr << "无法打开文件: " << path << std::endl;
+        return false;
+    }
+    FileHeader header{};
+    file_.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file_ || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        std::cerr << "不是间隙 PCM 文件: " << path << std::endl;
+        Close();
+        return false;
+    }
+    if (header.version != kVersion || header.channels == 0 ||
+        header.bytes_per_sample != FormatBytesPerSample(static_cast<snd_pcm_format_t>(header.format))) {
+        std::cerr << "不支持的间隙 PCM 文件版本或格式: " << path << std::endl;
+        Close();
+        return false;
+    }
+
+    sample_rate_ = static_cast<int>(header.sample_rate);
+    channels_ = header.channels;
+    format_ = static_cast<snd_pcm_format_t>(header.format);
+    bytes_per_sample_ = header.bytes_per_sample;
+    total_frames_ = header.total_frames;
+
+    mask_.assign((channels_ + 7) / 8, 0);
+    active_.clear();
+    active_.reserve(channels_);
+    remaining_ = 0;
+    silence_.assign(static_cast<size_t>(channels_) * bytes_per_sample_, 0);
+    snd_pcm_format_set_silence(format_, silence_.data(), channels_);
+    return true;
+}
+
+void GatedPcmReader::Close() {
+    if (file_.is_open()) file_.close();
+    file_.clear();
+    remaining_ = 0;
+}
+
+bool GatedPcmReader::Read(uint8_t* out, size_t max_frames, size_t* frames_read) {
+    *frames_read = 0;
+    if (!file_.is_open()) return false;
+
+    const size_t bps = static_cast<size_t>(bytes_per_sample_);
+    const size_t frame_bytes = channels_ * bps;
+    size_t done = 0;
+    while (done < max_frames) {
+        // 取下一条记录
+        if (remaining_ == 0) {
+            uint32_t frames = 0;
+            file_.read(reinterpret_cast<char*>(&frames), sizeof(frames));
+            if (file_.gcount() == 0 && file_.eof()) break;  // 正常结束
+            file_.read(reinterpret_cast<char*>(mask_.data()), mask_.size());
+            if (!file_) {
+                std::cerr << "间隙 PCM 文件记录头不完整" << std::endl;
+                return false;
+            }
+            active_.clear();
+            for (int c = 0; c < channels_; ++c) {
+                if (MaskBit(mask_.data(), c)) active_.push_back(c);
+            }
+            remaining_ = frames;
+            continue;
+        }
+
+        const size_t n = static_cast<size_t>(std::min<uint64_t>(remaining_, max_frames - done));
+        uint8_t* dst = out + done * frame_bytes;
+        if (active_.empty()) {
+            // 间隙
+            for (size_t f = 0; f < n; ++f) {
+                std::memcpy(dst + f * frame_bytes, silence_.data(), frame_bytes);
+            }
+        } else if (active_.size() == static_cast<size_t>(channels_)) {
+            file_.read(reinterpret_cast<char*>(dst), n * frame_bytes);
+        } else {
+            const size_t packed_frame = active_.size() * bps;
+            packed_.resize(n * packed_frame);
+            file_.read(reinterpret_cast<char*>(packed_.data()), packed_.size());
+            for (size_t f = 0; f < n; ++f) {
+                uint8_t* frame = dst + f * frame_bytes;
+                const uint8_t* src = packed_.data() + f * packed_frame;
+                std::memcpy(frame, silence_.data(), frame_bytes);
+                for (size_t k = 0; k < active_.size(); ++k) {
+                    std::memcpy(frame + active_[k] * bps, src + k * bps, bps);
+                }
+            }
+        }
+        if (!file_) {
+            std::cerr << "间隙 PCM 文件载荷不完整" << std::endl;
+            return false;
+        }
+        remaining_ -= n;
+        done += n;
+    }
+    *frames_read = done;
+    return true;
+}
@@ -0,0 +1,121 @@
+#include "huge_buffer.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+size_t RoundUp(size_t n, size_t align) {
+    return (n + align - 1) / align * align;
+}
+
+}  // namespace
+
+HugeBuffer::HugeBuffer()
+    : data_(nullptr),
+      size_(0),
+      mapped_(0),
+      huge_(false),
+      locked_(false)
+{
+}
+
+HugeBuffer::~HugeBuffer() {
+    Release();
+}
+
+HugeBuffer::HugeBuffer(HugeBuffer&& other) noexcept
+    : HugeBuffer() {
+    *this = std::move(other);
+}
+
+HugeBuffer& HugeBuffer::operator=(HugeBuffer&& other) noexcept {
+    if (this != &other) {
+        Release();
+        data_ = other.data_;
+        size_ = other.size_;
+        mapped_ = other.mapped_;
+        huge_ = other.huge_;
+        locked_ = other.locked_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.mapped_ = 0;
+        other.huge_ = false;
+        other.locked_ = false;
+    }
+    return *this;
+}
+
+bool HugeBuffer::Allocate(size_t bytes, bool use_hugepages, bool lock) {
+    Release();
+    if (bytes == 0) {
+        return false;
+    }
+
+    void* addr = MAP_FAILED;
+
+    // 1. 显式大页（需要预留 /proc/sys/vm/nr_hugepages）
+    if (use_hugepages) {
+        const size_t len = RoundUp(bytes, kHugePageSize);
+        addr = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+        if (addr != MAP_FAILED) {
+            mapped_ = len;
+            huge_ = true;
+        }
+    }
+
+    // 2. 普通匿名映射，建议使用透明大页
+    if (addr == MAP_FAILED) {
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t len = RoundUp(bytes, use_hugepages ? kHugePageSize : page);
+        addr = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED) {
+            std::cerr << "无法分配 " << bytes << " 字节: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        mapped_ = len;
+        huge_ = false;
+#ifdef MADV_HUGEPAGE
+        if (use_hugepages) {
+            madvise(addr, len, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    data_ = static_cast<uint8_t*>(addr);
+    size_ = bytes;
+
+    // 预缺页：逐页写入，保证之后的访问不再进入内核
+    std::memset(data_, 0, mapped_);
+
+    if (lock) {
+        if (mlock(data_, mapped_) == 0) {
+            locked_ = true;
+        } else {
+            std::cerr << "无法锁定内存（需要 CAP_IPC_LOCK 或提高 RLIMIT_MEMLOCK）: "
+                      << std::strerror(errno) << std::endl;
+        }
+    }
+    return true;
+}
+
+void HugeBuffer::Release() {
+    if (data_) {
+        if (locked_) {
+            munlock(data_, mapped_);
+        }
+        munmap(data_, mapped_);
+        data_ = nullptr;
+        size_ = 0;
+        mapped_ = 0;
+        huge_ = false;
+        locked_ = false;
+    }
+}
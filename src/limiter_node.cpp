@@ -0,0 +1,152 @@
+#include "limiter_node.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include "simd_ops.h"
+#include "true_peak.h"
+
+LimiterNode::LimiterNode()
+    : LimiterNode(Config())
+{
+}
+
+LimiterNode::LimiterNode(const Config& config)
+    : config_(config),
+      ceiling_(static_cast<float>(std::pow(10.0, config.ceiling_db / 20.0))),
+      true_peak_(config.true_peak)
+{
+}
+
+void LimiterNode::SetCeilingDb(double ceiling_db) {
+    ceiling_.store(static_cast<float>(std::pow(10.0, ceiling_db / 20.0)), std::memory_order_relaxed);
+}
+
+bool LimiterNode::Prepare(int sample_rate, int channels, size_t max_frames) {
+    DspNode::Prepare(sample_rate, channels, max_frames);
+    if (config_.release_ms <= 0.0 || config_.attack_ms <= 0.0) {
+        std::cerr << "限幅器参数无效: attack=" << config_.attack_ms
+                  << "ms, release=" << config_.release_ms << "ms" << std::endl;
+        return false;
+    }
+
+    const double lookahead_ms = std::min(std::max(config_.lookahead_ms, 0.5), 5.0);
+    const double attack_ms = std::min(config_.attack_ms, lookahead_ms);
+    hold_frames_ = std::max<size_t>(1, static_cast<size_t>(std::lround(lookahead_ms * sample_rate / 1000.0)));
+    attack_frames_ = std::max<size_t>(1, static_cast<size_t>(std::lround(attack_ms * sample_rate / 1000.0)));
+    attack_frames_ = std::min(attack_frames_, hold_frames_);
+    release_coef_ = std::exp(-1000.0 / (config_.release_ms * sample_rate));
+
+    // 检测器看的是插值窗口中心的样本，比输入晚 kTaps / 2 帧；
+    // 前瞻窗口再带来 hold_frames_ - 1 帧
+    delay_frames_ = kTaps / 2 + hold_frames_ - 1;
+
+    true_peak::MakeCoefficients(phase_coef_);
+
+    history_.assign(2 * kTaps * channels, 0.0f);
+    tp_acc_.assign(channels, 0.0f);
+    min_value_.assign(hold_frames_ + 1, 1.0f);
+    min_index_.assign(hold_frames_ + 1, 0);
+    box_.assign(attack_frames_, 1.0f);
+    gains_.assign(max_frames, 1.0f);
+    delay_.assign((delay_frames_ + max_frames) * channels, 0.0f);
+    Reset();
+    return true;
+}
+
+size_t LimiterNode::GetWarmupFrames() const {
+    const double release_frames = config_.release_ms * sample_rate_ / 1000.0;
+    return delay_frames_ + attack_frames_ +
+           static_cast<size_t>(std::ceil(release_frames * std::log(1e5)));
+}
+
+void LimiterNode::Reset() {
+    std::fill(history_.begin(), history_.end(), 0.0f);
+    history_pos_ = 0;
+    min_head_ = 0;
+    min_size_ = 0;
+    frame_index_ = 0;
+    std::fill(box_.begin(), box_.end(), 1.0f);
+    box_pos_ = 0;
+    box_sum_ = static_cast<double>(box_.size());
+    envelope_ = 1.0;
+    std::fill(delay_.begin(), delay_.end(), 0.0f);
+    reduction_db_.store(0.0, std::memory_order_relaxed);
+}
+
+void LimiterNode::Process(float* samples, size_t frames) {
+    const int ch = channels_;
+    const float ceiling = ceiling_.load(std::memory_order_relaxed);
+    const bool true_peak = true_peak_.load(std::memory_order_relaxed);
+    const size_t min_cap = min_value_.size();
+    float min_gain = 1.0f;
+
+    for (size_t f = 0; f < frames; ++f) {
+        // ---- 检测：所有通道联动取最大值 ----
+        const float* in = samples + f * ch;
+        float* slot = history_.data() + history_pos_ * ch;
+        std::memcpy(slot, in, ch * sizeof(float));
+        std::memcpy(slot + kTaps * ch, in, ch * sizeof(float));
+        history_pos_ = (history_pos_ + 1) % kTaps;
+        const float* window = history_.data() + history_pos_ * ch;  // 最旧 -> 最新
+
+        float peak = simd::AbsMax(window + (kTaps / 2 - 1) * ch, ch);
+        if (true_peak) {
+            for (int p = 1; p < kPhases; ++p) {
+                float* acc = tp_acc_.data();
+                std::fill(acc, acc + ch, 0.0f);
+                for (int k = 0; k < kTaps; ++k) {
+                    const float coef = phase_coef_[p][k];
+                    const float* x = window + k * ch;
+                    for (int c = 0; c < ch; ++c) {
+                        acc[c] += coef * x[c];
+                    }
+                }
+                peak = std::max(peak, simd::AbsMax(acc, ch));
+            }
+        }
+        const float required = peak > ceiling ? ceiling / peak : 1.0f;
+
+        // ---- 前瞻窗口内的滑动最小值（单调递增队列） ----
+        while (min_size_ > 0 &&
+               min_value_[(min_head_ + min_size_ - 1) % min_cap] >= required) {
+            --min_size_;
+        }
+        min_value_[(min_head_ + min_size_) % min_cap] = required;
+        min_index_[(min_head_ + min_size_) % min_cap] = frame_index_;
+        ++min_size_;
+        if (min_index_[min_head_] + hold_frames_ <= frame_index_) {
+            min_head_ = (min_head_ + 1) % min_cap;
+            --min_size_;
+        }
+        const float held = min_value_[min_head_];
+        ++frame_index_;
+
+        // ---- 攻击：滑动平均，使增益在峰值到达前平滑降到位 ----
+        box_sum_ += held - box_[box_pos_];
+        box_[box_pos_] = held;
+        box_pos_ = (box_pos_ + 1) % box_.size();
+        const double smoothed = std::min(1.0, box_sum_ / box_.size());
+
+        // ---- 释放：只对增益回升做指数平滑 ----
+        if (smoothed < envelope_) {
+            envelope_ = smoothed;
+        } else {
+            envelope_ = smoothed + (envelope_ - smoothed) * release_coef_;
+        }
+        gains_[f] = static_cast<float>(envelope_);
+        min_gain = std::min(min_gain, gains_[f]);
+    }
+
+    // ---- 音频延迟 delay_frames_ 帧，与增益对齐 ----
+    const size_t delayed = delay_frames_ * ch;
+    const size_t block = frames * ch;
+    std::memcpy(delay_.data() + delayed, samples, block * sizeof(float));
+    std::memcpy(samples, delay_.data(), block * sizeof(float));
+    std::memmove(delay_.data(), delay_.data() + block, delayed * sizeof(float));
+
+    simd::ApplyFrameGains(samples, gains_.data(), frames, ch);
+    reduction_db_.store(-20.0 * std::log10(std::max(min_gain, 1e-6f)), std::memory_order_relaxed);
+}
@@ -0,0 +1,368 @@
+#include "meter_tap.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include "simd_ops.h"
+#include "true_peak.h"
+
+namespace {
+
+constexpr float kFloorDb = -144.0f;          // 静音时报告的下限
+constexpr size_t kMomentaryBlocks = 4;       // 400 ms = 4 x 100 ms
+constexpr size_t kShortTermBlocks = 30;      // 3 s = 30 x 100 ms
+constexpr int kPollMs = 10;                  // 分析线程轮询间隔
+
+static_assert(true_peak::kPhases == 4 && true_peak::kTaps == 8, "tp_coef_ 尺寸与 true_peak.h 不符");
+
+float PowerToDb(double power) {
+    return power > 0.0 ? std::max(kFloorDb, static_cast<float>(10.0 * std::log10(power))) : kFloorDb;
+}
+
+float AmplitudeToDb(double amplitude) {
+    return amplitude > 0.0 ? std::max(kFloorDb, static_cast<float>(20.0 * std::log10(amplitude))) : kFloorDb;
+}
+
+}  // namespace
+
+MeterTap::MeterTap()
+    : MeterTap(Config())
+{
+}
+
+MeterTap::MeterTap(const Config& config)
+    : config_(config)
+{
+}
+
+MeterTap::~MeterTap() {
+    Stop();
+}
+
+bool MeterTap::Prepare(int sample_rate, int channels, size_t max_frames) {
+    if (running_) {
+        std::cerr << "电平表分析线程运行中，无法重新准备" << std::endl;
+        return false;
+    }
+    if (!dsp::IsPowerOfTwo(config_.fft_size) || config_.fft_size < 64) {
+        std::cerr << "电平表 FFT 点数必须是不小于 64 的 2 的幂: " << config_.fft_size << std::endl;
+        return false;
+    }
+    DspNode::Prepare(sample_rate, channels, max_frames);
+    const size_t ch = static_cast<size_t>(channels);
+
+    // ---- 槽位池：容纳 buffer_seconds 的音频 ----
+    const size_t slot_count = std::max<size_t>(
+        16, static_cast<size_t>(std::ceil(config_.buffer_seconds * sample_rate / max_frames)));
+    blocks_.assign(slot_count, Block());
+    for (auto& block : blocks_) {
+        block.samples.assign(max_frames * ch, 0.0f);
+        block.peak.assign(ch, 0.0f);
+        block.sum_sq.assign(ch, 0.0f);
+    }
+    free_ = std::make_unique<SpscQueue<uint32_t>>(slot_count);
+    filled_ = std::make_unique<SpscQueue<uint32_t>>(slot_count);
+    for (size_t i = 0; i < slot_count; ++i) {
+        free_->TryPush(static_cast<uint32_t>(i));
+    }
+    dropped_ = 0;
+
+    // ---- 电平与 true peak ----
+    peak_.assign(ch, 0.0f);
+    true_peak_.assign(ch, 0.0f);
+    mean_sq_.assign(ch, 0.0);
+    tp_history_.assign(2 * true_peak::kTaps * ch, 0.0f);
+    tp_pos_ = 0;
+    true_peak::MakeCoefficients(tp_coef_);
+
+    // ---- K 加权（BS.1770 两级滤波，按实际采样率由模拟原型重新推导） ----
+    {
+        const double f0 = 1681.974450955533;
+        const double gain_db = 3.999843853973347;
+        const double q = 0.7071752369554196;
+        const double k = std::tan(M_PI * f0 / sample_rate);
+        const double vh = std::pow(10.0, gain_db / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        shelf_.b0 = (vh + vb * k / q + k * k) / a0;
+        shelf_.b1 = 2.0 * (k * k - vh) / a0;
+        shelf_.b2 = (vh - vb * k / q + k * k) / a0;
+        shelf_.a1 = 2.0 * (k * k - 1.0) / a0;
+        shelf_.a2 = (1.0 - k / q + k * k) / a0;
+    }
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+        const double k = std::tan(M_PI * f0 / sample_rate);
+        const double a0 = 1.0 + k / q + k * k;
+        highpass_.b0 = 1.0;
+        highpass_.b1 = -2.0;
+        highpass_.b2 = 1.0;
+        highpass_.a1 = 2.0 * (k * k - 1.0) / a0;
+        highpass_.a2 = (1.0 - k / q + k * k) / a0;
+    }
+    for (Biquad* bq : {&shelf_, &highpass_}) {
+        bq->z1.assign(ch, 0.0);
+        bq->z2.assign(ch, 0.0);
+    }
+
+    // 5.1（L R C LFE Ls Rs）按 BS.1770 加权，其余布局各通道权重为 1
+    weights_.assign(ch, 1.0);
+    if (ch == 6) {
+        weights_[3] = 0.0;
+        weights_[4] = 1.41;
+        weights_[5] = 1.41;
+    }
+    block_sq_.assign(ch, 0.0);
+    block_frames_ = std::max<size_t>(1, static_cast<size_t>(sample_rate / 10));
+    block_fill_ = 0;
+    loudness_power_.assign(kShortTermBlocks, 0.0);
+    loudness_pos_ = 0;
+    loudness_count_ = 0;
+
+    // ---- 频谱 ----
+    const size_t n = config_.fft_size;
+    fft_ = std::make_unique<dsp::Fft>(n);
+    window_.resize(n);
+    window_gain_ = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        window_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * i / n));
+        window_gain_ += window_[i];
+    }
+    spec_history_.assign(n * ch, 0.0f);
+    spec_pos_ = 0;
+    fft_buf_.assign(n, std::complex<float>());
+    bins_ = n / 2 + 1;
+    spec_power_.assign(bins_ * ch, 0.0);
+
+    // ---- 发布区 ----
+    published_size_ = 2 + 3 * ch + bins_ * ch;
+    published_.reset(new std::atomic<float>[published_size_]);
+    for (size_t i = 0; i < published_size_; ++i) {
+        published_[i].store(kFloorDb, std::memory_order_relaxed);
+    }
+    seq_ = 0;
+    return true;
+}
+
+void MeterTap::Process(float* samples, size_t frames) {
+    uint32_t slot;
+    if (!free_ || !free_->TryPop(&slot)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Block& block = blocks_[slot];
+    const size_t ch = static_cast<size_t>(channels_);
+    std::fill(block.peak.begin(), block.peak.end(), 0.0f);
+    std::fill(block.sum_sq.begin(), block.sum_sq.end(), 0.0f);
+    simd::ChannelPeakSumSq(samples, frames, channels_, block.peak.data(), block.sum_sq.data());
+    std::memcpy(block.samples.data(), samples, frames * ch * sizeof(float));
+    block.frames = frames;
+    // 两个队列容量都不小于槽位数，不会满
+    filled_->TryPush(slot);
+}
+
+bool MeterTap::Start() {
+    if (running_) return true;
+    if (!published_) {
+        std::cerr << "电平表尚未准备" << std::endl;
+        return false;
+    }
+    running_ = true;
+    thread_ = std::thread(&MeterTap::AnalysisLoop, this);
+    return true;
+}
+
+void MeterTap::Stop() {
+    if (!running_.exchange(false)) return;
+    if (thread_.joinable()) thread_.join();
+}
+
+void MeterTap::AnalysisLoop() {
+    using Clock = std::chrono::steady_clock;
+    const auto interval = std::chrono::milliseconds(std::max(1, config_.publish_ms));
+    auto next_publish = Clock::now() + interval;
+
+    while (running_.load(std::memory_order_acquire)) {
+        uint32_t slot;
+        while (filled_->TryPop(&slot)) {
+            Analyze(blocks_[slot]);
+            free_->TryPush(slot);
+        }
+        const auto now = Clock::now();
+        if (now >= next_publish) {
+            Publish();
+            next_publish = std::max(next_publish + interval, now);
+        }
+        // 只轮询、不由音频线程唤醒：音频线程无需任何系统调用
+        std::this_thread::sleep_for(std::chrono::milliseconds(kPollMs));
+    }
+}
+
+void MeterTap::Analyze(const Block& block) {
+    const size_t ch = static_cast<size_t>(channels_);
+    const size_t n = config_.fft_size;
+    const size_t frames = block.frames;
+    if (frames == 0) return;
+
+    // ---- 样本峰值与 RMS：直接使用音频线程算好的块统计 ----
+    const double alpha =
+        1.0 - std::exp(-static_cast<double>(frames) * 1000.0 / (config_.rms_window_ms * sample_rate_));
+    for (size_t c = 0; c < ch; ++c) {
+        peak_[c] = std::max(peak_[c], block.peak[c]);
+        mean_sq_[c] += alpha * (block.sum_sq[c] / frames - mean_sq_[c]);
+    }
+
+    for (size_t f = 0; f < frames; ++f) {
+        const float* in = block.samples.data() + f * ch;
+
+        // ---- true peak：4 倍过采样插值，每通道独立 ----
+        float* slot = tp_history_.data() + tp_pos_ * ch;
+        std::memcpy(slot, in, ch * sizeof(float));
+        std::memcpy(slot + true_peak::kTaps * ch, in, ch * sizeof(float));
+        tp_pos_ = (tp_pos_ + 1) % true_peak::kTaps;
+        const float* window = tp_history_.data() + tp_pos_ * ch;  // 最旧 -> 最新
+        for (size_t c = 0; c < ch; ++c) {
+            float tp = std::fabs(window[true_peak::kCenter * ch + c]);
+            for (int p = 1; p < true_peak::kPhases; ++p) {
+                float acc = 0.0f;
+                for (int k = 0; k < true_peak::kTaps; ++k) {
+                    acc += tp_coef_[p][k] * window[k * ch + c];
+                }
+                tp = std::max(tp, std::fabs(acc));
+            }
+            true_peak_[c] = std::max(true_peak_[c], tp);
+        }
+
+        // ---- K 加权后累计 100 ms 子块的平方和 ----
+        for (size_t c = 0; c < ch; ++c) {
+            const double x = in[c];
+            const double s = shelf_.b0 * x + shelf_.z1[c];
+            shelf_.z1[c] = shelf_.b1 * x - shelf_.a1 * s + shelf_.z2[c];
+            shelf_.z2[c] = shelf_.b2 * x - shelf_.a2 * s;
+            const double y = highpass_.b0 * s + highpass_.z1[c];
+            highpass_.z1[c] = highpass_.b1 * s - highpass_.a1 * y + highpass_.z2[c];
+            highpass_.z2[c] = highpass_.b2 * s - highpass_.a2 * y;
+            block_sq_[c] += y * y;
+        }
+        if (++block_fill_ == block_frames_) {
+            double power = 0.0;
+            for (size_t c = 0; c < ch; ++c) {
+                power += weights_[c] * block_sq_[c] / block_frames_;
+                block_sq_[c] = 0.0;
+            }
+            loudness_power_[loudness_pos_] = power;
+            loudness_pos_ = (loudness_pos_ + 1) % kShortTermBlocks;
+            loudness_count_ = std::min(loudness_count_ + 1, kShortTermBlocks);
+            block_fill_ = 0;
+        }
+
+        // ---- 频谱历史 ----
+        for (size_t c = 0; c < ch; ++c) {
+            spec_history_[c * n + spec_pos_] = in[c];
+        }
+        spec_pos_ = (spec_pos_ + 1) % n;
+    }
+}
+
+void MeterTap::Publish() {
+    const size_t ch = static_cast<size_t>(channels_);
+    const size_t n = config_.fft_size;
+
+    // ---- 响度：最近 4 / 30 个子块功率的平均，启动阶段用已有的子块 ----
+    double momentary = 0.0;
+    double short_term = 0.0;
+    for (size_t i = 0; i < loudness_count_; ++i) {
+        const double power = loudness_power_[(loudness_pos_ + kShortTermBlocks - 1 - i) % kShortTermBlocks];
+        if (i < kMomentaryBlocks) momentary += power;
+        short_term += power;
+    }
+    momentary /= std::max<size_t>(1, std::min(loudness_count_, kMomentaryBlocks));
+    short_term /= std::max<size_t>(1, loudness_count_);
+
+    // ---- 频谱：最近 fft_size 帧加 Hann 窗，功率指数平均 ----
+    // 满量程正弦的峰值 |X| = window_gain / 2，据此归一化到 0 dBFS
+    const double norm = 4.0 / (window_gain_ * window_gain_);
+    const double smoothing = std::min(std::max(config_.spectrum_smoothing, 0.0), 0.99);
+    for (size_t c = 0; c < ch; ++c) {
+        const float* history = spec_history_.data() + c * n;
+        for (size_t i = 0; i < n; ++i) {
+            fft_buf_[i] = std::complex<float>(history[(spec_pos_ + i) % n] * window_[i], 0.0f);
+        }
+        fft_->Forward(fft_buf_.data());
+        double* power = spec_power_.data() + c * bins_;
+        for (size_t k = 0; k < bins_; ++k) {
+            const double p = std::norm(fft_buf_[k]) * norm;
+            power[k] = smoothing * power[k] + (1.0 - smoothing) * p;
+        }
+    }
+
+    // ---- seqlock 写：序号为奇数期间读者会重试 ----
+    const uint32_t seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::atomic<float>* out = published_.get();
+    out[0].store(PowerToDb(momentary) - 0.691f, std::memory_order_relaxed);
+    out[1].store(PowerToDb(short_term) - 0.691f, std::memory_order_relaxed);
+    out += 2;
+    for (size_t c = 0; c < ch; ++c) {
+        out[0].store(AmplitudeToDb(peak_[c]), std::memory_order_relaxed);
+        out[1].store(PowerToDb(mean_sq_[c]), std::memory_order_relaxed);
+        out[2].store(AmplitudeToDb(true_peak_[c]), std::memory_order_relaxed);
+        out += 3;
+    }
+    for (size_t i = 0; i < bins_ * ch; ++i) {
+        out[i].store(PowerToDb(spec_power_[i]), std::memory_order_relaxed);
+    }
+
+    seq_.store(seq + 2, std::memory_order_release);
+
+    // 峰值只统计一个发布间隔
+    std::fill(peak_.begin(), peak_.end(), 0.0f);
+    std::fill(true_peak_.begin(), true_peak_.end(), 0.0f);
+}
+
+bool MeterTap::ReadSnapshot(MeterSnapshot* out) const {
+    if (!published_) return false;
+    const size_t ch = static_cast<size_t>(channels_);
+    out->channels.resize(ch);
+    out->bins = bins_;
+    out->bin_hz = static_cast<double>(sample_rate_) / config_.fft_size;
+    out->spectrum_db.resize(bins_ * ch);
+    out->dropped_blocks = dropped_.load(std::memory_order_relaxed);
+
+    // 写者每 publish_ms 才写一次且很快写完，重试几次即可
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        const uint32_t begin = seq_.load(std::memory_order_acquire);
+        if (begin == 0) return false;  // 尚未发布
+        if (begin & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const std::atomic<float>* in = published_.get();
+        out->momentary_lufs = in[0].load(std::memory_order_relaxed);
+        out->short_term_lufs = in[1].load(std::memory_order_relaxed);
+        in += 2;
+        for (size_t c = 0; c < ch; ++c) {
+            out->channels[c].peak_db = in[0].load(std::memory_order_relaxed);
+            out->channels[c].rms_db = in[1].load(std::memory_order_relaxed);
+            out->channels[c].true_peak_db = in[2].load(std::memory_order_relaxed);
+            in += 3;
+        }
+        for (size_t i = 0; i < bins_ * ch; ++i) {
+            out->spectrum_db[i] = in[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) == begin) {
+            out->sequence = begin / 2;
+            return true;
+        }
+    }
+    return false;
+}
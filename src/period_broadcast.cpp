@@ -0,0 +1,297 @@
+#include "period_broadcast.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "futex_ops.h"
+
+namespace {
+
+constexpr uint64_t kCountMask = 0xffffffffu;
+
+// 每个块按缓存行对齐，避免相邻块的读写互相干扰
+size_t AlignUp(size_t n, size_t align) {
+    return (n + align - 1) / align * align;
+}
+
+}  // namespace
+
+// ========== Block ==========
+
+PeriodBroadcast::Block::Block(Block&& other) noexcept {
+    *this = std::move(other);
+}
+
+PeriodBroadcast::Block& PeriodBroadcast::Block::operator=(Block&& other) noexcept {
+    if (this != &other) {
+        Release();
+        owner_ = other.owner_;
+        index_ = other.index_;
+        data_ = other.data_;
+        bytes_ = other.bytes_;
+        frames_ = other.frames_;
+        seq_ = other.seq_;
+        other.owner_ = nullptr;
+        other.data_ = nullptr;
+    }
+    return *this;
+}
+
+void PeriodBroadcast::Block::Release() {
+    if (owner_) {
+        owner_->ReleaseBlock(index_);
+        owner_ = nullptr;
+        data_ = nullptr;
+        bytes_ = 0;
+        frames_ = 0;
+    }
+}
+
+// ========== PeriodBroadcast ==========
+
+PeriodBroadcast::PeriodBroadcast(size_t block_bytes, size_t depth, size_t max_readers)
+    : block_bytes_(block_bytes),
+      stride_(AlignUp(block_bytes, 64)),
+      depth_(depth > 0 ? depth : 1),
+      max_readers_(max_readers > 0 ? max_readers : 1),
+      pool_size_(depth_ + max_readers_ + 1),  // 环槽 + 每个读者借用一个 + 写端一个
+      storage_(pool_size_ * stride_),
+      blocks_(new BlockState[pool_size_]),
+      slots_(new std::atomic<uint32_t>[depth_]),
+      readers_(new ReaderState[max_readers_]),
+      pending_(0),
+      has_pending_(false),
+      next_scan_(0)
+{
+    for (size_t i = 0; i < depth_; ++i) {
+        slots_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+PeriodBroadcast::~PeriodBroadcast() {
+    Close();
+}
+
+uint8_t* PeriodBroadcast::BeginWrite() {
+    if (has_pending_) {
+        return BlockData(pending_);
+    }
+
+    // 在块池中找一个引用计数为 0 的块，并直接标记为即将发布的周期
+    const uint64_t gen = Generation(published_.load(std::memory_order_relaxed));
+    for (size_t n = 0; n < pool_size_; ++n) {
+        const size_t i = (next_scan_ + n) % pool_size_;
+        uint64_t tag = blocks_[i].tag.load(std::memory_order_relaxed);
+        if ((tag & kCountMask) != 0) {
+            continue;
+        }
+        if (blocks_[i].tag.compare_exchange_strong(tag, (gen << 32) | 1,
+                                                   std::memory_order_acq_rel,
+                                                   std::memory_order_relaxed)) {
+            pending_ = static_cast<uint32_t>(i);
+            has_pending_ = true;
+            next_scan_ = (i + 1) % pool_size_;
+            return BlockData(pending_);
+        }
+    }
+
+    // 所有块都被读者占着：丢弃本周期，绝不等待
+    dropped_writes_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void PeriodBroadcast::CommitWrite(int frames, size_t bytes) {
+    if (!has_pending_) {
+        return;
+    }
+
+    BlockState& block = blocks_[pending_];
+    block.frames = frames;
+    block.bytes = bytes < block_bytes_ ? bytes : block_bytes_;
+
+    // 放入环槽；被挤出的旧块失去环槽持有的引用
+    const uint64_t seq = published_.load(std::memory_order_relaxed);
+    const uint32_t old = slots_[seq % depth_].exchange(pending_, std::memory_order_acq_rel);
+    if (seq >= depth_) {
+        ReleaseBlock(old);
+    }
+    has_pending_ = false;
+
+    published_.store(seq + 1, std::memory_order_release);
+    WakeReaders();
+}
+
+void PeriodBroadcast::AbortWrite() {
+    if (!has_pending_) {
+        return;
+    }
+    blocks_[pending_].tag.store(0, std::memory_order_release);
+    has_pending_ = false;
+}
+
+bool PeriodBroadcast::Publish(const uint8_t* data, int frames, size_t bytes) {
+    uint8_t* dst = BeginWrite();
+    if (!dst) {
+        return false;
+    }
+    if (bytes > block_bytes_) {
+        bytes = block_bytes_;
+    }
+    std::memcpy(dst, data, bytes);
+    CommitWrite(frames, bytes);
+    return true;
+}
+
+void PeriodBroadcast::Close() {
+    if (closed_.exchange(true)) {
+        return;
+    }
+    futex::NotifyAll(&futex_word_);
+}
+
+int PeriodBroadcast::AddReader(SlowReaderPolicy policy) {
+    for (size_t i = 0; i < max_readers_; ++i) {
+        bool expected = false;
+        if (readers_[i].in_use.compare_exchange_strong(expected, true)) {
+            readers_[i].policy = policy;
+            readers_[i].dropped.store(false, std::memory_order_relaxed);
+            readers_[i].skipped.store(0, std::memory_order_relaxed);
+            readers_[i].cursor.store(published_.load(std::memory_order_acquire),
+                                     std::memory_order_relaxed);
+            return static_cast<int>(i);
+        }
+    }
+    std::cerr << "广播读者已满: " << max_readers_ << std::endl;
+    return -1;
+}
+
+void PeriodBroadcast::RemoveReader(int reader) {
+    if (reader < 0 || static_cast<size_t>(reader) >= max_readers_) {
+        return;
+    }
+    readers_[reader].in_use.store(false, std::memory_order_release);
+}
+
+PeriodBroadcast::ReadStatus PeriodBroadcast::Read(int reader, Block* out, int timeout_ms) {
+    out->Release();
+    if (reader < 0 || static_cast<size_t>(reader) >= max_readers_) {
+        std::cerr << "无效的广播读者: " << reader << std::endl;
+        return ReadStatus::kDropped;
+    }
+
+    ReaderState& st = readers_[reader];
+    if (st.dropped.load(std::memory_order_relaxed)) {
+        return ReadStatus::kDropped;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms < 0 ? 0 : timeout_ms);
+    bool skipped = false;
+
+    while (true) {
+        const uint64_t cur = st.cursor.load(std::memory_order_relaxed);
+        const uint64_t pub = published_.load(std::memory_order_acquire);
+
+        // 没有新数据：等待
+        if (cur >= pub) {
+            if (closed_.load(std::memory_order_acquire)) {
+                return ReadStatus::kClosed;
+            }
+            int remain_ms = -1;
+            if (timeout_ms >= 0) {
+                remain_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - Clock::now()).count());
+                if (remain_ms <= 0) {
+                    return ReadStatus::kTimeout;
+                }
+            }
+            WaitForData(cur, remain_ms);
+            continue;
+        }
+
+        // 慢消费者：需要的周期已被覆盖
+        if (pub - cur > depth_) {
+            if (st.policy == SlowReaderPolicy::kDrop) {
+                st.dropped.store(true, std::memory_order_relaxed);
+                std::cerr << "广播读者 " << reader << " 落后 " << (pub - cur)
+                          << " 个周期，已摘除" << std::endl;
+                return ReadStatus::kDropped;
+            }
+            const uint64_t oldest = pub - depth_;
+            st.skipped.fetch_add(oldest - cur, std::memory_order_relaxed);
+            st.cursor.store(oldest, std::memory_order_relaxed);
+            skipped = true;
+            continue;
+        }
+
+        const uint32_t index = slots_[cur % depth_].load(std::memory_order_acquire);
+        if (!TryAcquire(index, cur)) {
+            // 取块的同时被写端覆盖，下一轮按落后处理
+            continue;
+        }
+
+        const BlockState& block = blocks_[index];
+        out->owner_ = this;
+        out->index_ = index;
+        out->data_ = BlockData(index);
+        out->bytes_ = block.bytes;
+        out->frames_ = block.frames;
+        out->seq_ = cur;
+        st.cursor.store(cur + 1, std::memory_order_relaxed);
+        return skipped ? ReadStatus::kSkipped : ReadStatus::kOk;
+    }
+}
+
+uint64_t PeriodBroadcast::GetLag(int reader) const {
+    if (reader < 0 || static_cast<size_t>(reader) >= max_readers_) {
+        return 0;
+    }
+    const uint64_t pub = published_.load(std::memory_order_acquire);
+    const uint64_t cur = readers_[reader].cursor.load(std::memory_order_relaxed);
+    return pub > cur ? pub - cur : 0;
+}
+
+uint64_t PeriodBroadcast::GetSkippedPeriods(int reader) const {
+    if (reader < 0 || static_cast<size_t>(reader) >= max_readers_) {
+        return 0;
+    }
+    return readers_[reader].skipped.load(std::memory_order_relaxed);
+}
+
+// 仅当块仍是 seq 对应的代号且环槽引用尚在时才增加引用计数
+bool PeriodBroadcast::TryAcquire(uint32_t index, uint64_t seq) {
+    std::atomic<uint64_t>& tag = blocks_[index].tag;
+    const uint64_t gen = Generation(seq);
+    uint64_t cur = tag.load(std::memory_order_acquire);
+    while ((cur >> 32) == gen && (cur & kCountMask) != 0) {
+        if (tag.compare_exchange_weak(cur, cur + 1,
+                                      std::memory_order_acq_rel,
+                                      std::memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PeriodBroadcast::ReleaseBlock(uint32_t index) {
+    blocks_[index].tag.fetch_sub(1, std::memory_order_release);
+}
+
+bool PeriodBroadcast::WaitForData(uint64_t cursor, int timeout_ms) {
+    const uint32_t observed = futex_word_.load(std::memory_order_seq_cst);
+    if (published_.load(std::memory_order_acquire) > cursor ||
+        closed_.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    // 值已变化（期间有新发布）时内核立即返回，不会丢失唤醒
+    futex::WaitAsWaiter(&futex_word_, observed, &waiters_, timeout_ms);
+
+    return published_.load(std::memory_order_acquire) > cursor ||
+           closed_.load(std::memory_order_acquire);
+}
+
+void PeriodBroadcast::WakeReaders() {
+    futex::Notify(&futex_word_, waiters_);
+}
@@ -0,0 +1,241 @@
+#include "period_pool.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "futex_ops.h"
+
+namespace {
+
+constexpr uint64_t kIndexMask = 0xffffffffu;
+
+// 每个块按缓存行对齐，避免相邻块的读写互相干扰
+size_t AlignUp(size_t n, size_t align) {
+    return (n + align - 1) / align * align;
+}
+
+}  // namespace
+
+// ========== Block ==========
+
+PeriodPool::Block::Block(Block&& other) noexcept {
+    *this = std::move(other);
+}
+
+PeriodPool::Block& PeriodPool::Block::operator=(Block&& other) noexcept {
+    if (this != &other) {
+        Release();
+        owner_ = other.owner_;
+        index_ = other.index_;
+        data_ = other.data_;
+        other.owner_ = nullptr;
+        other.data_ = nullptr;
+    }
+    return *this;
+}
+
+size_t PeriodPool::Block::capacity_frames() const {
+    return owner_ ? owner_->block_frames_ : 0;
+}
+
+size_t PeriodPool::Block::capacity_bytes() const {
+    return owner_ ? owner_->block_bytes_ : 0;
+}
+
+size_t PeriodPool::Block::frames() const {
+    return owner_ ? owner_->headers_[index_].frames : 0;
+}
+
+void PeriodPool::Block::set_frames(size_t frames) {
+    if (owner_) {
+        owner_->headers_[index_].frames = frames < owner_->block_frames_ ? frames : owner_->block_frames_;
+    }
+}
+
+void PeriodPool::Block::Release() {
+    if (owner_) {
+        owner_->Push(index_);
+        owner_ = nullptr;
+        data_ = nullptr;
+    }
+}
+
+// ========== PeriodPool ==========
+
+PeriodPool::PeriodPool()
+    : block_frames_(0),
+      frame_bytes_(0),
+      block_bytes_(0),
+      stride_(0),
+      block_count_(0)
+{
+}
+
+PeriodPool::~PeriodPool() {
+    const size_t free_count = free_count_.load(std::memory_order_relaxed);
+    if (free_count != block_count_) {
+        std::cerr << "[PeriodPool] 销毁时仍有 " << block_count_ - free_count << " 个块未归还" << std::endl;
+    }
+}
+
+bool PeriodPool::Init(size_t block_frames, size_t frame_bytes, size_t block_count,
+                      bool use_hugepages, bool lock) {
+    if (block_frames == 0 || frame_bytes == 0 || block_count == 0 || block_count >= kNil) {
+        std::cerr << "无效的块池参数: " << block_frames << " 帧 x " << frame_bytes << " 字节 x "
+                  << block_count << " 块" << std::endl;
+        return false;
+    }
+    if (free_count_.load(std::memory_order_relaxed) != block_count_) {
+        std::cerr << "块池仍有块未归还，无法重新初始化" << std::endl;
+        return false;
+    }
+
+    block_frames_ = block_frames;
+    frame_bytes_ = frame_bytes;
+    block_bytes_ = block_frames * frame_bytes;
+    stride_ = AlignUp(block_bytes_, 64);
+    block_count_ = 0;
+    free_count_.store(0, std::memory_order_relaxed);
+    head_.store(kNil, std::memory_order_relaxed);
+
+    if (!storage_.Allocate(stride_ * block_count, use_hugepages, lock)) {
+        return false;
+    }
+    headers_.reset(new BlockHeader[block_count]);
+    block_count_ = block_count;
+
+    // 按下标倒序入栈，先取出的是低地址的块
+    for (size_t i = block_count; i-- > 0;) {
+        Push(static_cast<uint32_t>(i));
+    }
+
+    std::cout << "[PeriodPool] " << block_count_ << " 块 x " << block_bytes_ << " 字节"
+              << (storage_.IsHugePages() ? "，大页" : "")
+              << (storage_.IsLocked() ? "，已锁定" : "") << std::endl;
+    return true;
+}
+
+PeriodPool::Block PeriodPool::Acquire() {
+    const uint32_t index = Pop();
+    if (index == kNil) {
+        exhausted_.fetch_add(1, std::memory_order_relaxed);
+        return Block();
+    }
+    headers_[index].frames = 0;
+    return Adopt(index);
+}
+
+PeriodPool::Block PeriodPool::Adopt(uint32_t index) {
+    Block block;
+    block.owner_ = this;
+    block.index_ = index;
+    block.data_ = BlockData(index);
+    return block;
+}
+
+uint32_t PeriodPool::Detach(Block* block) {
+    const uint32_t index = block->index_;
+    block->owner_ = nullptr;
+    block->data_ = nullptr;
+    return index;
+}
+
+uint32_t PeriodPool::Pop() {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    while (true) {
+        const uint32_t index = static_cast<uint32_t>(head & kIndexMask);
+        if (index == kNil) {
+            return kNil;
+        }
+        // 读到的 next 可能已过时（块被别的线程取走又放回），此时代号不同，CAS 必然失败
+        const uint32_t next = headers_[index].next.load(std::memory_order_relaxed);
+        const uint64_t desired = (((head >> 32) + 1) << 32) | next;
+        if (head_.compare_exchange_weak(head, desired, std::memory_order_acquire,
+                                        std::memory_order_acquire)) {
+            free_count_.fetch_sub(1, std::memory_order_relaxed);
+            return index;
+        }
+    }
+}
+
+void PeriodPool::Push(uint32_t index) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    while (true) {
+        headers_[index].next.store(static_cast<uint32_t>(head & kIndexMask), std::memory_order_relaxed);
+        const uint64_t desired = (((head >> 32) + 1) << 32) | index;
+        // release：归还前对块的读写先于下一个取得者可见
+        if (head_.compare_exchange_weak(head, desired, std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+            free_count_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+// ========== PeriodQueue ==========
+
+PeriodQueue::PeriodQueue(PeriodPool* pool, size_t capacity)
+    : pool_(pool),
+      queue_(capacity)
+{
+}
+
+PeriodQueue::~PeriodQueue() {
+    // 归还还留在队列中的块
+    PeriodPool::Block block;
+    while (TryPop(&block)) {
+        block.Release();
+    }
+}
+
+bool PeriodQueue::Push(PeriodPool::Block* block) {
+    if (!block->valid() || block->owner_ != pool_) {
+        return false;
+    }
+    if (!queue_.TryPush(block->index_)) {
+        return false;
+    }
+    PeriodPool::Detach(block);
+    Wake();
+    return true;
+}
+
+bool PeriodQueue::TryPop(PeriodPool::Block* out) {
+    uint32_t index;
+    if (!queue_.TryPop(&index)) {
+        return false;
+    }
+    *out = pool_->Adopt(index);
+    return true;
+}
+
+bool PeriodQueue::Pop(PeriodPool::Block* out, int timeout_ms) {
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms < 0 ? 0 : timeout_ms);
+    while (true) {
+        if (TryPop(out)) return true;
+        if (closed_.load(std::memory_order_acquire)) return false;
+
+        // 先取 futex 字再复查队列：复查之后的入队必然改变 futex 字，等待会立即返回
+        const uint32_t observed = futex_word_.load(std::memory_order_seq_cst);
+        if (TryPop(out)) return true;
+        if (closed_.load(std::memory_order_acquire)) return false;
+
+        int remain_ms = -1;
+        if (timeout_ms >= 0) {
+            remain_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - Clock::now()).count());
+            if (remain_ms <= 0) return false;
+        }
+        futex::WaitAsWaiter(&futex_word_, observed, &waiters_, remain_ms);
+    }
+}
+
+void PeriodQueue::Close() {
+    closed_.store(true, std::memory_order_release);
+    futex::NotifyAll(&futex_word_);
+}
+
+void PeriodQueue::Wake() {
+    futex::Notify(&futex_word_, waiters_);
+}
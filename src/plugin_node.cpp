@@ -0,0 +1,281 @@
+#include "plugin_node.h"
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+constexpr size_t kRetireCapacity = 16;
+constexpr int kWorkerPollMs = 20;  // 后台线程检查退役队列的间隔
+
+}  // namespace
+
+PluginNode::Module::~Module() {
+    if (handle) dlclose(handle);
+}
+
+PluginNode::PluginNode()
+    : PluginNode(Config())
+{
+}
+
+PluginNode::PluginNode(const Config& config)
+    : config_(config),
+      retired_(kRetireCapacity)
+{
+}
+
+PluginNode::~PluginNode() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+
+    // 音频线程已不再运行，剩余实例都在这里销毁
+    DrainRetired();
+    DestroyInstance(pending_.exchange(nullptr));
+    DestroyInstance(retire_hold_);
+    if (crossfading_) DestroyInstance(fading_);
+    DestroyInstance(active_);
+}
+
+bool PluginNode::Prepare(int sample_rate, int channels, size_t max_frames) {
+    DspNode::Prepare(sample_rate, channels, max_frames);
+    fade_frames_ = static_cast<size_t>(config_.crossfade_ms * sample_rate / 1000.0);
+    dry_.assign(max_frames * channels, 0.0f);
+
+    // 已生效的实例按新参数重新准备（只在处理开始前调用）
+    if (active_ && active_->descriptor &&
+        active_->descriptor->prepare(active_->handle, sample_rate, channels,
+                                     static_cast<uint32_t>(max_frames)) != 0) {
+        std::cerr << "插件重新准备失败: " << GetActiveName() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// ========== 音频线程 ==========
+
+void PluginNode::RunInstance(Instance* instance, float* samples, size_t frames) {
+    if (instance && instance->descriptor) {
+        instance->descriptor->process(instance->handle, samples, static_cast<uint32_t>(frames));
+    }
+}
+
+void PluginNode::Retire(Instance* instance) {
+    if (instance && !retired_.TryPush(instance)) {
+        retire_hold_ = instance;
+    }
+}
+
+void PluginNode::Process(float* samples, size_t frames) {
+    if (retire_hold_ && retired_.TryPush(retire_hold_)) {
+        retire_hold_ = nullptr;
+    }
+
+    // 只在块边界、且上一次替换已经完成时接入新实例
+    if (!crossfading_ && !retire_hold_) {
+        Instance* next = pending_.exchange(nullptr, std::memory_order_acq_rel);
+        if (next) {
+            fading_ = active_;
+            active_ = next;
+            fade_pos_ = 0;
+            crossfading_ = true;
+            active_id_.store(next->id, std::memory_order_relaxed);
+            swaps_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (!crossfading_) {
+        RunInstance(active_, samples, frames);
+        return;
+    }
+    if (fade_pos_ >= fade_frames_) {
+        // 不做淡化（crossfade_ms 为 0）
+        Retire(fading_);
+        fading_ = nullptr;
+        crossfading_ = false;
+        RunInstance(active_, samples, frames);
+        return;
+    }
+
+    // 旧实例处理输入的副本，新实例就地处理，再按帧线性混合
+    const size_t ch = static_cast<size_t>(channels_);
+    std::memcpy(dry_.data(), samples, frames * ch * sizeof(float));
+    RunInstance(fading_, dry_.data(), frames);
+    RunInstance(active_, samples, frames);
+    const float step = 1.0f / static_cast<float>(fade_frames_);
+    for (size_t f = 0; f < frames; ++f) {
+        const float t = std::min(1.0f, static_cast<float>(fade_pos_ + f) * step);
+        float* out = samples + f * ch;
+        const float* old = dry_.data() + f * ch;
+        for (size_t c = 0; c < ch; ++c) {
+            out[c] = old[c] + t * (out[c] - old[c]);
+        }
+    }
+    fade_pos_ += frames;
+    if (fade_pos_ >= fade_frames_) {
+        Retire(fading_);
+        fading_ = nullptr;
+        crossfading_ = false;
+    }
+}
+
+void PluginNode::Reset() {
+    if (crossfading_) {
+        Retire(fading_);
+        fading_ = nullptr;
+        crossfading_ = false;
+    }
+    if (active_ && active_->descriptor && active_->descriptor->reset) {
+        active_->descriptor->reset(active_->handle);
+    }
+}
+
+// ========== 控制线程 ==========
+
+bool PluginNode::Load(const std::string& path, const std::string& config) {
+    if (max_frames_ == 0) {
+        std::cerr << "插件槽尚未准备，无法加载: " << path << std::endl;
+        return false;
+    }
+    if (!EnsureWorker()) return false;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        requests_.push_back(Request{false, path, config});
+    }
+    cv_.notify_all();
+    return true;
+}
+
+bool PluginNode::Unload() {
+    if (!EnsureWorker()) return false;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        requests_.push_back(Request{true, std::string(), std::string()});
+    }
+    cv_.notify_all();
+    return true;
+}
+
+std::string PluginNode::GetActiveName() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = names_.find(active_id_.load(std::memory_order_relaxed));
+    return it != names_.end() ? it->second : std::string();
+}
+
+std::string PluginNode::GetLastError() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return last_error_;
+}
+
+bool PluginNode::EnsureWorker() {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (stop_) return false;
+    if (!worker_.joinable()) {
+        worker_ = std::thread(&PluginNode::WorkerLoop, this);
+    }
+    return true;
+}
+
+// ========== 后台线程 ==========
+
+void PluginNode::WorkerLoop() {
+    std::unique_lock<std::mutex> lk(mu_);
+    while (!stop_) {
+        cv_.wait_for(lk, std::chrono::milliseconds(kWorkerPollMs),
+                     [this] { return stop_ || !requests_.empty(); });
+        while (!stop_ && !requests_.empty()) {
+            Request request = std::move(requests_.front());
+            requests_.pop_front();
+
+            // dlopen、create、prepare 可能很慢，不持锁
+            lk.unlock();
+            Instance* instance = CreateInstance(request);
+            if (instance) {
+                // 还没被音频线程取走的上一个实例从未生效，直接销毁
+                DestroyInstance(pending_.exchange(instance, std::memory_order_acq_rel));
+            }
+            lk.lock();
+        }
+        lk.unlock();
+        DrainRetired();
+        lk.lock();
+    }
+}
+
+PluginNode::Instance* PluginNode::CreateInstance(const Request& request) {
+    auto fail = [this](const std::string& message) -> Instance* {
+        std::cerr << "[Plugin] " << message << std::endl;
+        std::lock_guard<std::mutex> lk(mu_);
+        last_error_ = message;
+        return nullptr;
+    };
+
+    auto instance = std::make_unique<Instance>();
+    std::string name;
+    if (!request.unload) {
+        auto module = std::make_shared<Module>();
+        module->handle = dlopen(request.path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (!module->handle) {
+            return fail("无法加载插件 " + request.path + ": " + dlerror());
+        }
+        auto entry = reinterpret_cast<arp_plugin_entry_fn>(dlsym(module->handle, ARP_PLUGIN_ENTRY_SYMBOL));
+        if (!entry) {
+            return fail("插件缺少入口 " ARP_PLUGIN_ENTRY_SYMBOL ": " + request.path);
+        }
+        const arp_plugin_descriptor* descriptor = entry();
+        if (!descriptor || descriptor->api_version != ARP_PLUGIN_API_VERSION ||
+            !descriptor->create || !descriptor->prepare || !descriptor->process || !descriptor->destroy) {
+            return fail("插件接口版本不符或描述符不完整: " + request.path);
+        }
+        module->descriptor = descriptor;
+        // ABI 不要求 name 非空，只在这里解析一次，之后都用 name
+        name = descriptor->name ? descriptor->name : request.path;
+
+        void* handle = descriptor->create(request.config.c_str());
+        if (!handle) {
+            return fail("插件实例创建失败: " + name);
+        }
+        if (descriptor->prepare(handle, sample_rate_, channels_, static_cast<uint32_t>(max_frames_)) != 0) {
+            descriptor->destroy(handle);
+            return fail("插件准备失败: " + name);
+        }
+        instance->module = std::move(module);
+        instance->descriptor = descriptor;
+        instance->handle = handle;
+    }
+
+    std::lock_guard<std::mutex> lk(mu_);
+    instance->id = next_id_++;
+    names_[instance->id] = name;
+    if (!request.unload) {
+        std::cout << "[Plugin] " << name << " 已就绪，等待切换" << std::endl;
+    }
+    return instance.release();
+}
+
+void PluginNode::DestroyInstance(Instance* instance) {
+    if (!instance) return;
+    if (instance->descriptor) {
+        instance->descriptor->destroy(instance->handle);
+    }
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        names_.erase(instance->id);
+    }
+    delete instance;  // 释放对 Module 的引用，最后一个实例释放时 dlclose
+}
+
+void PluginNode::DrainRetired() {
+    Instance* instance;
+    while (retired_.TryPop(&instance)) {
+        DestroyInstance(instance);
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef SHM_CAPTURE_LAYOUT_H
+#define SHM_CAPTURE_LAYOUT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 采集共享内存的内存布局，发布端与订阅端共用（进程间 ABI，修改须升级版本号）
+//
+//   [ShmCaptureHeader][ShmSlotHeader + 数据][ShmSlotHeader + 数据]...
+//
+// 发布端是唯一写者；订阅端只读映射，按 seqlock 方式校验槽位：
+// 槽位 seq 为 0 表示正在写入，为 n + 1 表示存放第 n 个周期。
+//
+// 等待计数 ShmWaitState 放在另一个可读写的小 memfd 中（不含任何音频数据）：
+// 头部在订阅端是只读映射，订阅端无法在其中登记自己正在等待。
+
+namespace shm_capture {
+
+constexpr uint32_t kMagic   = 0x53505241;  // "ARPS"
+constexpr uint32_t kVersion = 2;
+constexpr size_t kAlign     = 64;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "需要无锁 64 位原子量");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "需要无锁 32 位原子量");
+
+struct ShmCaptureHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t sample_rate;
+  uint32_t channels;
+  int32_t format;            // snd_pcm_format_t 的数值
+  uint32_t bytes_per_frame;
+  uint32_t slot_count;
+  uint32_t slot_bytes;       // 每个槽位的数据容量
+  uint64_t slot_stride;      // 槽位间距（含槽头）
+  uint64_t slots_offset;     // 第一个槽位相对映射起点的偏移
+
+  alignas(kAlign) std::atomic<uint64_t> write_seq;  // 已发布的周期数
+  alignas(kAlign) std::atomic<uint32_t> futex_word; // 每次发布加一，订阅端在其上等待
+  std::atomic<uint32_t> closed;
+};
+
+// 订阅端在 futex 等待前后增减 waiters，发布端没有等待者时不做唤醒系统调用。
+// 等待中崩溃的订阅端会让计数偏大，只会多出唤醒调用，不影响正确性。
+struct alignas(kAlign) ShmWaitState {
+  std::atomic<uint32_t> waiters;
+};
+
+struct alignas(kAlign) ShmSlotHeader {
+  std::atomic<uint64_t> seq;
+  uint32_t frames;
+  uint32_t bytes;
+  int64_t timestamp_ns;  // 发布时刻（CLOCK_MONOTONIC）
+};
+
+// 随 SCM_RIGHTS 一起发送的握手消息，附带两个描述符：只读的数据 memfd 与可写的等待计数 memfd
+constexpr int kHandshakeFds = 2;
+
+struct ShmHandshake {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t map_size;
+};
+
+inline size_t AlignUp(size_t n) {
+  return (n + kAlign - 1) / kAlign * kAlign;
+}
+
+}  // namespace shm_capture
+
+#endif  // SHM_CAPTURE_LAYOUT_H
@@ -0,0 +1,340 @@
+#include "shm_capture_publisher.h"
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <new>
+
+#include "shm_capture_layout.h"
+
+using shm_capture::ShmCaptureHeader;
+using shm_capture::ShmHandshake;
+using shm_capture::ShmSlotHeader;
+using shm_capture::ShmWaitState;
+
+namespace {
+
+int64_t MonotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// 共享（非 PRIVATE）futex：订阅端在其他进程中等待
+void FutexWakeShared(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+}  // namespace
+
+// 构造函数：只记录参数，资源在 Open 中创建
+ShmCapturePublisher::ShmCapturePublisher(const std::string& socket_path,
+                                         int sample_rate,
+                                         int channels,
+                                         snd_pcm_format_t format)
+    : socket_path_(socket_path),
+      sample_rate_(sample_rate),
+      channels_(channels),
+      format_(format),
+      memfd_(-1),
+      readonly_fd_(-1),
+      wait_fd_(-1),
+      listen_fd_(-1),
+      map_size_(0),
+      slot_bytes_(0),
+      slot_count_(0),
+      slot_stride_(0),
+      base_(nullptr),
+      header_(nullptr),
+      wait_(nullptr),
+      writing_(false)
+{
+}
+
+ShmCapturePublisher::~ShmCapturePublisher() {
+    Close();
+}
+
+bool ShmCapturePublisher::Open(size_t period_bytes, size_t slot_count) {
+    if (header_) {
+        return true;
+    }
+    if (period_bytes == 0 || slot_count < 2) {
+        std::cerr << "共享内存参数无效: period_bytes=" << period_bytes
+                  << " slot_count=" << slot_count << std::endl;
+        return false;
+    }
+
+    slot_bytes_  = period_bytes;
+    slot_count_  = slot_count;
+    slot_stride_ = shm_capture::AlignUp(sizeof(ShmSlotHeader) + period_bytes);
+    const size_t slots_offset = shm_capture::AlignUp(sizeof(ShmCaptureHeader));
+    map_size_ = slots_offset + slot_stride_ * slot_count_;
+
+    // 创建匿名共享内存，并禁止之后改变大小
+    memfd_ = memfd_create("arp_capture", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (memfd_ < 0) {
+        std::cerr << "memfd_create 失败: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(memfd_, static_cast<off_t>(map_size_)) < 0) {
+        std::cerr << "无法设置共享内存大小: " << std::strerror(errno) << std::endl;
+        Close();
+        return false;
+    }
+    fcntl(memfd_, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL);
+
+    void* addr = mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      memfd_, 0);
+    if (addr == MAP_FAILED) {
+        std::cerr << "无法映射共享内存: " << std::strerror(errno) << std::endl;
+        Close();
+        return false;
+    }
+    base_ = static_cast<uint8_t*>(addr);
+
+    // 订阅端只拿到只读描述符，无法以可写方式映射；拿不到只读描述符则不发布
+    const std::string self_fd = "/proc/self/fd/" + std::to_string(memfd_);
+    readonly_fd_ = open(self_fd.c_str(), O_RDONLY | O_CLOEXEC);
+    if (readonly_fd_ < 0) {
+        std::cerr << "无法创建只读描述符: " << std::strerror(errno) << std::endl;
+        Close();
+        return false;
+    }
+
+    // 等待计数页：订阅端可写，只放计数，不含音频数据
+    wait_fd_ = memfd_create("arp_capture_wait", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (wait_fd_ < 0 || ftruncate(wait_fd_, sizeof(ShmWaitState)) < 0) {
+        std::cerr << "无法创建等待计数页: " << std::strerror(errno) << std::endl;
+        Close();
+        return false;
+    }
+    fcntl(wait_fd_, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL);
+    void* wait_addr = mmap(nullptr, sizeof(ShmWaitState), PROT_READ | PROT_WRITE, MAP_SHARED,
+                           wait_fd_, 0);
+    if (wait_addr == MAP_FAILED) {
+        std::cerr << "无法映射等待计数页: " << std::strerror(errno) << std::endl;
+        Close();
+        return false;
+    }
+    wait_ = new (wait_addr) ShmWaitState();
+    wait_->waiters.store(0, std::memory_order_relaxed);
+
+    // 初始化头部与槽位
+    ShmCaptureHeader* header = new (base_) ShmCaptureHeader();
+    header->magic           = shm_capture::kMagic;
+    header->version         = shm_capture::kVersion;
+    header->sample_rate     = static_cast<uint32_t>(sample_rate_);
+    header->channels        = static_cast<uint32_t>(channels_);
+    header->format          = static_cast<int32_t>(format_);
+    header->bytes_per_frame = static_cast<uint32_t>(
+        channels_ * snd_pcm_format_physical_width(format_) / 8);
+    header->slot_count      = static_cast<uint32_t>(slot_count_);
+    header->slot_bytes      = static_cast<uint32_t>(slot_bytes_);
+    header->slot_stride     = slot_stride_;
+    header->slots_offset    = slots_offset;
+    header->write_seq.store(0, std::memory_order_relaxed);
+    header->futex_word.store(0, std::memory_order_relaxed);
+    header->closed.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < slot_count_; ++i) {
+        ShmSlotHeader* slot = new (base_ + slots_offset + i * slot_stride_) ShmSlotHeader();
+        slot->seq.store(0, std::memory_order_relaxed);
+    }
+    header_ = header;
+
+    // 监听 UNIX 套接字
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "无法创建套接字: " << std::strerror(errno) << std::endl;
+        Close();
+        return false;
+    }
+    sockaddr_un addr_un;
+    std::memset(&addr_un, 0, sizeof(addr_un));
+    addr_un.sun_family = AF_UNIX;
+    if (socket_path_.size() >= sizeof(addr_un.sun_path)) {
+        std::cerr << "套接字路径过长: " << socket_path_ << std::endl;
+        Close();
+        return false;
+    }
+    std::strncpy(addr_un.sun_path, socket_path_.c_str(), sizeof(addr_un.sun_path) - 1);
+    unlink(socket_path_.c_str());
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr_un), sizeof(addr_un)) < 0 ||
+        listen(listen_fd_, 16) < 0) {
+        std::cerr << "无法监听套接字 " << socket_path_ << ": " << std::strerror(errno) << std::endl;
+        Close();
+        return false;
+    }
+
+    accepting_ = true;
+    accept_thread_ = std::thread(&ShmCapturePublisher::AcceptLoop, this);
+
+    std::cout << "共享采集已发布: " << socket_path_ << "，" << slot_count_ << " 个槽位 x "
+              << slot_bytes_ << " 字节" << std::endl;
+    return true;
+}
+
+void ShmCapturePublisher::Close() {
+    if (header_) {
+        // 通知订阅端结束
+        header_->closed.store(1, std::memory_order_release);
+        header_->futex_word.fetch_add(1, std::memory_order_seq_cst);
+        FutexWakeShared(&header_->futex_word);
+    }
+
+    accepting_ = false;
+    if (accept_thread_.joinable()) {
+        accept_thread_.join();
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+        unlink(socket_path_.c_str());
+    }
+    if (base_) {
+        munmap(base_, map_size_);
+        base_ = nullptr;
+        header_ = nullptr;
+    }
+    if (wait_) {
+        munmap(wait_, sizeof(ShmWaitState));
+        wait_ = nullptr;
+    }
+    if (wait_fd_ >= 0) {
+        close(wait_fd_);
+        wait_fd_ = -1;
+    }
+    if (readonly_fd_ >= 0) {
+        close(readonly_fd_);
+        readonly_fd_ = -1;
+    }
+    if (memfd_ >= 0) {
+        close(memfd_);
+        memfd_ = -1;
+    }
+    writing_ = false;
+}
+
+ShmSlotHeader* ShmCapturePublisher::Slot(uint64_t seq) const {
+    return reinterpret_cast<ShmSlotHeader*>(
+        base_ + header_->slots_offset + (seq % slot_count_) * slot_stride_);
+}
+
+uint8_t* ShmCapturePublisher::BeginWrite() {
+    if (!header_) {
+        return nullptr;
+    }
+    const uint64_t seq = header_->write_seq.load(std::memory_order_relaxed);
+    ShmSlotHeader* slot = Slot(seq);
+    if (!writing_) {
+        // 先作废槽位，订阅端据此发现数据正在被覆盖
+        slot->seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        writing_ = true;
+    }
+    return reinterpret_cast<uint8_t*>(slot) + sizeof(ShmSlotHeader);
+}
+
+void ShmCapturePublisher::CommitWrite(int frames, size_t bytes) {
+    if (!header_ || !writing_) {
+        return;
+    }
+    const uint64_t seq = header_->write_seq.load(std::memory_order_relaxed);
+    ShmSlotHeader* slot = Slot(seq);
+    slot->frames = static_cast<uint32_t>(frames);
+    slot->bytes = static_cast<uint32_t>(bytes < slot_bytes_ ? bytes : slot_bytes_);
+    slot->timestamp_ns = MonotonicNs();
+    slot->seq.store(seq + 1, std::memory_order_release);
+    header_->write_seq.store(seq + 1, std::memory_order_release);
+    writing_ = false;
+
+    // 无论多少订阅端都至多一次唤醒系统调用；没有订阅端在等待时不进入内核
+    header_->futex_word.fetch_add(1, std::memory_order_seq_cst);
+    if (wait_->waiters.load(std::memory_order_seq_cst) > 0) {
+        FutexWakeShared(&header_->futex_word);
+    }
+}
+
+bool ShmCapturePublisher::Publish(const uint8_t* data, int frames, size_t bytes) {
+    uint8_t* dst = BeginWrite();
+    if (!dst) {
+        return false;
+    }
+    if (bytes > slot_bytes_) {
+        bytes = slot_bytes_;
+    }
+    std::memcpy(dst, data, bytes);
+    CommitWrite(frames, bytes);
+    return true;
+}
+
+uint64_t ShmCapturePublisher::GetPublished() const {
+    return header_ ? header_->write_seq.load(std::memory_order_acquire) : 0;
+}
+
+// 接受订阅端连接，发送共享内存描述符后即断开
+void ShmCapturePublisher::AcceptLoop() {
+    while (accepting_) {
+        pollfd pfd;
+        pfd.fd = listen_fd_;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int ret = poll(&pfd, 1, 200);
+        if (ret <= 0) {
+            continue;
+        }
+        int client = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            continue;
+        }
+        if (SendMemfd(client)) {
+            served_.fetch_add(1, std::memory_order_relaxed);
+        }
+        close(client);
+    }
+}
+
+bool ShmCapturePublisher::SendMemfd(int client_fd) {
+    ShmHandshake hs;
+    hs.magic = shm_capture::kMagic;
+    hs.version = shm_capture::kVersion;
+    hs.map_size = map_size_;
+
+    iovec iov;
+    iov.iov_base = &hs;
+    iov.iov_len = sizeof(hs);
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * shm_capture::kHandshakeFds)];
+    std::memset(control, 0, sizeof(control));
+
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * shm_capture::kHandshakeFds);
+    // 只发送只读描述符，可写的 memfd_ 永远不离开本进程
+    const int fds[shm_capture::kHandshakeFds] = {readonly_fd_, wait_fd_};
+    std::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    if (sendmsg(client_fd, &msg, MSG_NOSIGNAL) < 0) {
+        std::cerr << "发送共享内存描述符失败: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
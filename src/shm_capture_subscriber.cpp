@@ -0,0 +1,281 @@
+#include "shm_capture_subscriber.h"
+
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+#include "shm_capture_layout.h"
+
+using shm_capture::ShmCaptureHeader;
+using shm_capture::ShmHandshake;
+using shm_capture::ShmSlotHeader;
+using shm_capture::ShmWaitState;
+
+namespace {
+
+// 头部来自另一个进程，使用前核对槽位布局确实落在映射范围内
+bool ValidateLayout(const ShmCaptureHeader* header, uint64_t map_size) {
+    const uint64_t count = header->slot_count;
+    const uint64_t stride = header->slot_stride;
+    const uint64_t offset = header->slots_offset;
+    if (count < 2 || stride % shm_capture::kAlign != 0 || offset % shm_capture::kAlign != 0 ||
+        offset < sizeof(ShmCaptureHeader) ||
+        stride < sizeof(ShmSlotHeader) + static_cast<uint64_t>(header->slot_bytes)) {
+        return false;
+    }
+    // offset + stride * count <= map_size，按除法比较避免溢出
+    return offset <= map_size && stride <= (map_size - offset) / count;
+}
+
+}  // namespace
+
+ShmCaptureSubscriber::ShmCaptureSubscriber(const std::string& socket_path)
+    : socket_path_(socket_path),
+      base_(nullptr),
+      map_size_(0),
+      header_(nullptr),
+      wait_(nullptr),
+      cursor_(0),
+      skipped_(0)
+{
+}
+
+ShmCaptureSubscriber::~ShmCaptureSubscriber() {
+    Close();
+}
+
+bool ShmCaptureSubscriber::Open() {
+    if (header_) {
+        return true;
+    }
+
+    int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        std::cerr << "无法创建套接字: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+    if (connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "无法连接共享采集 " << socket_path_ << ": " << std::strerror(errno) << std::endl;
+        close(sock);
+        return false;
+    }
+
+    // 接收握手消息、只读数据 memfd 与等待计数 memfd
+    ShmHandshake hs;
+    iovec iov;
+    iov.iov_base = &hs;
+    iov.iov_len = sizeof(hs);
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * shm_capture::kHandshakeFds)];
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+    close(sock);
+    // 内核已经安装了对端发来的全部描述符（超出 control 容量的部分由内核关闭），
+    // 数量与预期不符（例如旧版发布端只发一个 memfd）时也必须逐个关闭，否则每次重连都泄漏
+    int fds[shm_capture::kHandshakeFds] = {-1, -1};
+    size_t fd_count = 0;
+    cmsghdr* cmsg = (n > 0) ? CMSG_FIRSTHDR(&msg) : nullptr;
+    if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+        cmsg->cmsg_len >= CMSG_LEN(0)) {
+        fd_count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        if (fd_count > shm_capture::kHandshakeFds) {
+            fd_count = shm_capture::kHandshakeFds;
+        }
+        std::memcpy(fds, CMSG_DATA(cmsg), fd_count * sizeof(int));
+    }
+    auto close_fds = [&fds]() {
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+    };
+    if (n != static_cast<ssize_t>(sizeof(hs)) || fd_count != shm_capture::kHandshakeFds ||
+        fds[0] < 0 || fds[1] < 0) {
+        std::cerr << "未收到共享内存描述符" << std::endl;
+        close_fds();
+        return false;
+    }
+    if (hs.magic != shm_capture::kMagic || hs.version != shm_capture::kVersion) {
+        std::cerr << "共享采集版本不匹配" << std::endl;
+        close_fds();
+        return false;
+    }
+
+    // 以实际文件大小为准，防止握手信息与文件不一致
+    struct stat st;
+    struct stat wait_st;
+    if (fstat(fds[0], &st) < 0 || static_cast<uint64_t>(st.st_size) < hs.map_size ||
+        hs.map_size < sizeof(ShmCaptureHeader) ||
+        fstat(fds[1], &wait_st) < 0 || static_cast<uint64_t>(wait_st.st_size) < sizeof(ShmWaitState)) {
+        std::cerr << "共享内存大小异常" << std::endl;
+        close_fds();
+        return false;
+    }
+
+    void* mem = mmap(nullptr, hs.map_size, PROT_READ, MAP_SHARED, fds[0], 0);
+    void* wait_mem = mmap(nullptr, sizeof(ShmWaitState), PROT_READ | PROT_WRITE, MAP_SHARED, fds[1], 0);
+    close_fds();  // 映射建立后描述符不再需要
+    if (mem == MAP_FAILED || wait_mem == MAP_FAILED) {
+        std::cerr << "无法映射共享内存: " << std::strerror(errno) << std::endl;
+        if (mem != MAP_FAILED) munmap(mem, hs.map_size);
+        if (wait_mem != MAP_FAILED) munmap(wait_mem, sizeof(ShmWaitState));
+        return false;
+    }
+
+    base_ = static_cast<const uint8_t*>(mem);
+    map_size_ = hs.map_size;
+    header_ = reinterpret_cast<const ShmCaptureHeader*>(base_);
+    wait_ = static_cast<ShmWaitState*>(wait_mem);
+    if (!ValidateLayout(header_, map_size_)) {
+        std::cerr << "共享采集槽位布局与映射大小不符" << std::endl;
+        Close();
+        return false;
+    }
+    cursor_ = header_->write_seq.load(std::memory_order_acquire);
+    skipped_ = 0;
+
+    std::cout << "已订阅共享采集: " << socket_path_ << " (" << header_->sample_rate << "Hz, "
+              << header_->channels << "通道)" << std::endl;
+    return true;
+}
+
+void ShmCaptureSubscriber::Close() {
+    if (wait_) {
+        munmap(wait_, sizeof(ShmWaitState));
+        wait_ = nullptr;
+    }
+    if (base_) {
+        munmap(const_cast<uint8_t*>(base_), map_size_);
+        base_ = nullptr;
+        header_ = nullptr;
+    }
+}
+
+const ShmSlotHeader* ShmCaptureSubscriber::Slot(uint64_t seq) const {
+    return reinterpret_cast<const ShmSlotHeader*>(
+        base_ + header_->slots_offset + (seq % header_->slot_count) * header_->slot_stride);
+}
+
+ShmCaptureSubscriber::ReadStatus ShmCaptureSubscriber::Acquire(Period* out, int timeout_ms) {
+    if (!header_) {
+        return ReadStatus::kClosed;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms < 0 ? 0 : timeout_ms);
+    // 正在写入的槽位不可读，最多可落后 slot_count - 1 个周期
+    const uint64_t window = header_->slot_count - 1;
+    bool skipped = false;
+
+    while (true) {
+        const uint32_t observed = header_->futex_word.load(std::memory_order_seq_cst);
+        const uint64_t pub = header_->write_seq.load(std::memory_order_acquire);
+
+        if (cursor_ >= pub) {
+            if (header_->closed.load(std::memory_order_acquire)) {
+                return ReadStatus::kClosed;
+            }
+            int remain_ms = -1;
+            if (timeout_ms >= 0) {
+                remain_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - Clock::now()).count());
+                if (remain_ms <= 0) {
+                    return ReadStatus::kTimeout;
+                }
+            }
+            Wait(observed, remain_ms);
+            continue;
+        }
+
+        if (pub - cursor_ > window) {
+            skipped_ += pub - window - cursor_;
+            cursor_ = pub - window;
+            skipped = true;
+        }
+
+        const ShmSlotHeader* slot = Slot(cursor_);
+        const uint64_t tag = slot->seq.load(std::memory_order_acquire);
+        if (tag != cursor_ + 1) {
+            // 已被覆盖（或正在覆盖），重新按落后处理
+            ++skipped_;
+            ++cursor_;
+            skipped = true;
+            continue;
+        }
+
+        out->data = reinterpret_cast<const uint8_t*>(slot) + sizeof(ShmSlotHeader);
+        out->bytes = slot->bytes;
+        out->frames = static_cast<int>(slot->frames);
+        out->seq = cursor_;
+        out->timestamp_ns = slot->timestamp_ns;
+        ++cursor_;
+        return skipped ? ReadStatus::kSkipped : ReadStatus::kOk;
+    }
+}
+
+bool ShmCaptureSubscriber::Validate(const Period& period) const {
+    if (!header_) {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return Slot(period.seq)->seq.load(std::memory_order_relaxed) == period.seq + 1;
+}
+
+void ShmCaptureSubscriber::Wait(uint32_t observed, int timeout_ms) const {
+    timespec ts;
+    const timespec* timeout = nullptr;
+    if (timeout_ms >= 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000L;
+        timeout = &ts;
+    }
+    // 共享（非 PRIVATE）futex，只读映射上同样可以等待。
+    // 先登记等待者：发布端看到计数为 0 时，其 futex_word 的递增已先于登记，
+    // FUTEX_WAIT 比较时会发现值已变化而立即返回，不会丢失唤醒
+    wait_->waiters.fetch_add(1, std::memory_order_seq_cst);
+    syscall(SYS_futex, const_cast<uint32_t*>(reinterpret_cast<const uint32_t*>(&header_->futex_word)),
+            FUTEX_WAIT, observed, timeout, nullptr, 0);
+    wait_->waiters.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+int ShmCaptureSubscriber::GetSampleRate() const {
+    return header_ ? static_cast<int>(header_->sample_rate) : 0;
+}
+
+int ShmCaptureSubscriber::GetChannels() const {
+    return header_ ? static_cast<int>(header_->channels) : 0;
+}
+
+int ShmCaptureSubscriber::GetFormat() const {
+    return header_ ? header_->format : -1;
+}
+
+int ShmCaptureSubscriber::GetBytesPerFrame() const {
+    return header_ ? static_cast<int>(header_->bytes_per_frame) : 0;
+}
+
+uint64_t ShmCaptureSubscriber::GetLag() const {
+    if (!header_) {
+        return 0;
+    }
+    const uint64_t pub = header_->write_seq.load(std::memory_order_acquire);
+    return pub > cursor_ ? pub - cursor_ : 0;
+}
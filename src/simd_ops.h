@@ -0,0 +1,201 @@
+#ifndef SIMD_OPS_H
+#define SIMD_OPS_H
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// 处理节点内部使用的 SIMD 基本运算（x86 SSE2 / ARM NEON，其余平台走标量实现）。
+// 只在 src/ 内部使用，不属于公共接口。
+
+namespace simd {
+
+// max |x[i]|
+inline float AbsMax(const float* x, size_t n) {
+  size_t i = 0;
+  float result = 0.0f;
+#if defined(__SSE2__)
+  const __m128 sign = _mm_set1_ps(-0.0f);
+  __m128 acc = _mm_setzero_ps();
+  for (; i + 4 <= n; i += 4) {
+    acc = _mm_max_ps(acc, _mm_andnot_ps(sign, _mm_loadu_ps(x + i)));
+  }
+  float lanes[4];
+  _mm_storeu_ps(lanes, acc);
+  result = std::fmax(std::fmax(lanes[0], lanes[1]), std::fmax(lanes[2], lanes[3]));
+#elif defined(__ARM_NEON)
+  float32x4_t acc = vdupq_n_f32(0.0f);
+  for (; i + 4 <= n; i += 4) {
+    acc = vmaxq_f32(acc, vabsq_f32(vld1q_f32(x + i)));
+  }
+  float lanes[4];
+  vst1q_f32(lanes, acc);
+  result = std::fmax(std::fmax(lanes[0], lanes[1]), std::fmax(lanes[2], lanes[3]));
+#endif
+  for (; i < n; ++i) {
+    result = std::fmax(result, std::fabs(x[i]));
+  }
+  return result;
+}
+
+// 交错样本逐帧乘以各自的增益：samples[f * channels + c] *= gains[f]
+inline void ApplyFrameGains(float* samples, const float* gains, size_t frames, int channels) {
+  size_t f = 0;
+#if defined(__SSE2__)
+  if (channels == 1) {
+    for (; f + 4 <= frames; f += 4) {
+      _mm_storeu_ps(samples + f, _mm_mul_ps(_mm_loadu_ps(samples + f), _mm_loadu_ps(gains + f)));
+    }
+  } else if (channels == 2) {
+    // 两帧一组：[g0 g0 g1 g1]
+    for (; f + 2 <= frames; f += 2) {
+      const __m128 g = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(gains + f)));
+      float* p = samples + f * 2;
+      _mm_storeu_ps(p, _mm_mul_ps(_mm_loadu_ps(p), _mm_unpacklo_ps(g, g)));
+    }
+  } else if (channels % 4 == 0) {
+    for (; f < frames; ++f) {
+      const __m128 g = _mm_set1_ps(gains[f]);
+      float* p = samples + f * channels;
+      for (int c = 0; c < channels; c += 4) {
+        _mm_storeu_ps(p + c, _mm_mul_ps(_mm_loadu_ps(p + c), g));
+      }
+    }
+  }
+#elif defined(__ARM_NEON)
+  if (channels == 1) {
+    for (; f + 4 <= frames; f += 4) {
+      vst1q_f32(samples + f, vmulq_f32(vld1q_f32(samples + f), vld1q_f32(gains + f)));
+    }
+  } else if (channels == 2) {
+    for (; f + 2 <= frames; f += 2) {
+      const float32x2_t g = vld1_f32(gains + f);
+      const float32x4_t gg = vcombine_f32(vdup_lane_f32(g, 0), vdup_lane_f32(g, 1));
+      float* p = samples + f * 2;
+      vst1q_f32(p, vmulq_f32(vld1q_f32(p), gg));
+    }
+  } else if (channels % 4 == 0) {
+    for (; f < frames; ++f) {
+      const float32x4_t g = vdupq_n_f32(gains[f]);
+      float* p = samples + f * channels;
+      for (int c = 0; c < channels; c += 4) {
+        vst1q_f32(p + c, vmulq_f32(vld1q_f32(p + c), g));
+      }
+    }
+  }
+#endif
+  // 剩余帧与其他通道数
+  for (; f < frames; ++f) {
+    const float g = gains[f];
+    float* p = samples + f * channels;
+    for (int c = 0; c < channels; ++c) {
+      p[c] *= g;
+    }
+  }
+}
+
+// 交错样本逐通道累计峰值与平方和：
+//   peak[c] = max(peak[c], |x|)，sum_sq[c] += x²
+// 1/2 通道时每个向量跨多帧，4 的倍数（不超过 kMaxVectorChannels）时每帧若干个向量
+constexpr int kMaxVectorChannels = 64;
+
+inline void ChannelPeakSumSq(const float* samples, size_t frames, int channels,
+                             float* peak, float* sum_sq) {
+  size_t f = 0;
+#if defined(__SSE2__)
+  const __m128 sign = _mm_set1_ps(-0.0f);
+  if (channels == 1 || channels == 2) {
+    // 每个向量覆盖 4 / channels 帧，lane l 对应通道 l % channels
+    const size_t step = 4 / channels;
+    __m128 pk = _mm_setzero_ps();
+    __m128 sq = _mm_setzero_ps();
+    for (; f + step <= frames; f += step) {
+      const __m128 x = _mm_loadu_ps(samples + f * channels);
+      pk = _mm_max_ps(pk, _mm_andnot_ps(sign, x));
+      sq = _mm_add_ps(sq, _mm_mul_ps(x, x));
+    }
+    float lanes_pk[4], lanes_sq[4];
+    _mm_storeu_ps(lanes_pk, pk);
+    _mm_storeu_ps(lanes_sq, sq);
+    for (int l = 0; l < 4; ++l) {
+      peak[l % channels] = std::fmax(peak[l % channels], lanes_pk[l]);
+      sum_sq[l % channels] += lanes_sq[l];
+    }
+  } else if (channels % 4 == 0 && channels <= kMaxVectorChannels) {
+    const int vectors = channels / 4;
+    __m128 pk[kMaxVectorChannels / 4];
+    __m128 sq[kMaxVectorChannels / 4];
+    for (int v = 0; v < vectors; ++v) {
+      pk[v] = _mm_loadu_ps(peak + v * 4);
+      sq[v] = _mm_setzero_ps();
+    }
+    for (; f < frames; ++f) {
+      const float* p = samples + f * channels;
+      for (int v = 0; v < vectors; ++v) {
+        const __m128 x = _mm_loadu_ps(p + v * 4);
+        pk[v] = _mm_max_ps(pk[v], _mm_andnot_ps(sign, x));
+        sq[v] = _mm_add_ps(sq[v], _mm_mul_ps(x, x));
+      }
+    }
+    for (int v = 0; v < vectors; ++v) {
+      _mm_storeu_ps(peak + v * 4, pk[v]);
+      _mm_storeu_ps(sum_sq + v * 4, _mm_add_ps(_mm_loadu_ps(sum_sq + v * 4), sq[v]));
+    }
+  }
+#elif defined(__ARM_NEON)
+  if (channels == 1 || channels == 2) {
+    const size_t step = 4 / channels;
+    float32x4_t pk = vdupq_n_f32(0.0f);
+    float32x4_t sq = vdupq_n_f32(0.0f);
+    for (; f + step <= frames; f += step) {
+      const float32x4_t x = vld1q_f32(samples + f * channels);
+      pk = vmaxq_f32(pk, vabsq_f32(x));
+      sq = vmlaq_f32(sq, x, x);
+    }
+    float lanes_pk[4], lanes_sq[4];
+    vst1q_f32(lanes_pk, pk);
+    vst1q_f32(lanes_sq, sq);
+    for (int l = 0; l < 4; ++l) {
+      peak[l % channels] = std::fmax(peak[l % channels], lanes_pk[l]);
+      sum_sq[l % channels] += lanes_sq[l];
+    }
+  } else if (channels % 4 == 0 && channels <= kMaxVectorChannels) {
+    const int vectors = channels / 4;
+    float32x4_t pk[kMaxVectorChannels / 4];
+    float32x4_t sq[kMaxVectorChannels / 4];
+    for (int v = 0; v < vectors; ++v) {
+      pk[v] = vld1q_f32(peak + v * 4);
+      sq[v] = vdupq_n_f32(0.0f);
+    }
+    for (; f < frames; ++f) {
+      const float* p = samples + f * channels;
+      for (int v = 0; v < vectors; ++v) {
+        const float32x4_t x = vld1q_f32(p + v * 4);
+        pk[v] = vmaxq_f32(pk[v], vabsq_f32(x));
+        sq[v] = vmlaq_f32(sq[v], x, x);
+      }
+    }
+    for (int v = 0; v < vectors; ++v) {
+      vst1q_f32(peak + v * 4, pk[v]);
+      vst1q_f32(sum_sq + v * 4, vaddq_f32(vld1q_f32(sum_sq + v * 4), sq[v]));
+    }
+  }
+#endif
+  // 剩余帧与其他通道数
+  for (; f < frames; ++f) {
+    const float* p = samples + f * channels;
+    for (int c = 0; c < channels; ++c) {
+      peak[c] = std::fmax(peak[c], std::fabs(p[c]));
+      sum_sq[c] += p[c] * p[c];
+    }
+  }
+}
+
+}  // namespace simd
+
+#endif  // SIMD_OPS_H
@@ -0,0 +1,36 @@
+#ifndef TRUE_PEAK_H
+#define TRUE_PEAK_H
+
+#include <cmath>
+
+// true-peak 检测用的 4 倍过采样插值系数（限幅器与电平表共用）。
+//
+// 第 p 相估计中心样本之后 p/4 处的值，输入窗口为中心样本前 3 帧到后 4 帧共 8 帧，
+// 系数为 Hann 窗 sinc，每相归一化为单位直流增益。检测结果比输入晚 kTaps / 2 帧。
+
+namespace true_peak {
+
+constexpr int kTaps = 8;
+constexpr int kPhases = 4;
+constexpr int kCenter = kTaps / 2 - 1;  // 窗口中心样本的下标
+
+inline void MakeCoefficients(float coef[kPhases][kTaps]) {
+  for (int p = 0; p < kPhases; ++p) {
+    double c[kTaps];
+    double sum = 0.0;
+    for (int k = 0; k < kTaps; ++k) {
+      const double t = static_cast<double>(p) / kPhases - (k - kCenter);
+      const double sinc = (t == 0.0) ? 1.0 : std::sin(M_PI * t) / (M_PI * t);
+      const double window = 0.5 * (1.0 + std::cos(M_PI * t / (kTaps / 2)));
+      c[k] = sinc * window;
+      sum += c[k];
+    }
+    for (int k = 0; k < kTaps; ++k) {
+      coef[p][k] = static_cast<float>(c[k] / sum);
+    }
+  }
+}
+
+}  // namespace true_peak
+
+#endif  // TRUE_PEAK_H
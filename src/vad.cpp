@@ -0,0 +1,150 @@
+#include "vad.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "simd_ops.h"
+
+namespace {
+
+constexpr double kFloorDb = -144.0;
+
+double PowerToDb(double power) {
+    return power > 0.0 ? std::max(kFloorDb, 10.0 * std::log10(power)) : kFloorDb;
+}
+
+}  // namespace
+
+VoiceActivityDetector::VoiceActivityDetector(int sample_rate, int channels)
+    : VoiceActivityDetector(sample_rate, channels, Config())
+{
+}
+
+VoiceActivityDetector::VoiceActivityDetector(int sample_rate, int channels, const Config& config)
+    : sample_rate_(sample_rate),
+      channels_(channels),
+      config_(config),
+      peak_(channels, 0.0f),
+      sum_sq_(channels, 0.0f),
+      noise_db_(channels, config.threshold_db),
+      hangover_(channels, 0),
+      mask_((channels + 7) / 8, 0),
+      segment_mask_((channels + 7) / 8, 0),
+      fft_(dsp::NextPowerOfTwo(std::max<size_t>(config.fft_size, 16))),
+      scratch_(kMaxFrames * channels, 0.0f)
+{
+    hangover_frames_ = static_cast<size_t>(config_.hangover_ms * sample_rate_ / 1000.0);
+    const size_t n = fft_.GetSize();
+    window_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        window_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * i / n));
+    }
+    fft_buf_.assign(n, std::complex<float>());
+}
+
+void VoiceActivityDetector::Reset() {
+    std::fill(noise_db_.begin(), noise_db_.end(), config_.threshold_db);
+    std::fill(hangover_.begin(), hangover_.end(), 0);
+    std::fill(mask_.begin(), mask_.end(), 0);
+    any_active_ = false;
+}
+
+bool VoiceActivityDetector::Process(const float* samples, size_t frames) {
+    any_active_ = Analyze(samples, frames);
+    std::memcpy(mask_.data(), segment_mask_.data(), mask_.size());
+    return any_active_;
+}
+
+bool VoiceActivityDetector::ProcessInterleaved(const dsp::KernelSet& kernels, const uint8_t* pcm,
+                                               size_t frames) {
+    std::fill(mask_.begin(), mask_.end(), 0);
+    any_active_ = false;
+    while (frames > 0) {
+        const size_t n = std::min(frames, kMaxFrames);
+        kernels.ToFloat(pcm, scratch_.data(), n);
+        any_active_ |= Analyze(scratch_.data(), n);
+        for (size_t i = 0; i < mask_.size(); ++i) {
+            mask_[i] |= segment_mask_[i];
+        }
+        pcm += n * kernels.frame_bytes;
+        frames -= n;
+    }
+    return any_active_;
+}
+
+bool VoiceActivityDetector::Analyze(const float* samples, size_t frames) {
+    std::fill(segment_mask_.begin(), segment_mask_.end(), 0);
+    if (frames == 0) return false;
+
+    std::fill(peak_.begin(), peak_.end(), 0.0f);
+    std::fill(sum_sq_.begin(), sum_sq_.end(), 0.0f);
+    simd::ChannelPeakSumSq(samples, frames, channels_, peak_.data(), sum_sq_.data());
+
+    const double rise_db = config_.noise_rise_db_per_s * frames / sample_rate_;
+    bool any = false;
+    uint64_t active_channels = 0;
+    for (int c = 0; c < channels_; ++c) {
+        const double energy_db = PowerToDb(sum_sq_[c] / frames);
+
+        bool active = false;
+        if (energy_db >= config_.loud_db) {
+            active = true;
+        } else if (energy_db >= config_.threshold_db &&
+                   energy_db > noise_db_[c] + config_.snr_db) {
+            active = SpectralFlatness(samples, frames, c) <= config_.max_flatness;
+        }
+
+        // 噪声底：下降立即跟随，上升只在静音块上缓慢进行
+        if (energy_db < noise_db_[c]) {
+            noise_db_[c] = energy_db;
+        } else if (!active) {
+            noise_db_[c] = std::min(energy_db, noise_db_[c] + rise_db);
+        }
+
+        // 拖尾
+        if (active) {
+            hangover_[c] = hangover_frames_;
+        } else if (hangover_[c] > 0) {
+            hangover_[c] -= std::min(hangover_[c], frames);
+            active = true;
+        }
+
+        if (active) {
+            segment_mask_[c >> 3] |= static_cast<uint8_t>(1u << (c & 7));
+            any = true;
+            ++active_channels;
+        }
+    }
+
+    total_frames_.fetch_add(frames, std::memory_order_relaxed);
+    if (any) {
+        active_frames_.fetch_add(frames, std::memory_order_relaxed);
+        active_channel_frames_.fetch_add(active_channels * frames, std::memory_order_relaxed);
+    }
+    return any;
+}
+
+// 块末 fft_size 帧（不足时补零）加 Hann 窗后的频谱平坦度，跳过直流
+float VoiceActivityDetector::SpectralFlatness(const float* samples, size_t frames, int channel) {
+    const size_t n = fft_.GetSize();
+    const size_t count = std::min(frames, n);
+    const float* src = samples + (frames - count) * channels_ + channel;
+    for (size_t i = 0; i < n; ++i) {
+        const float x = i < count ? src[i * channels_] * window_[i] : 0.0f;
+        fft_buf_[i] = std::complex<float>(x, 0.0f);
+    }
+    fft_.Forward(fft_buf_.data());
+
+    const size_t bins = n / 2;
+    double log_sum = 0.0;
+    double sum = 0.0;
+    for (size_t k = 1; k <= bins; ++k) {
+        const double p = std::norm(fft_buf_[k]) + 1e-20;
+        log_sum += std::log(p);
+        sum += p;
+    }
+    const double geometric = std::exp(log_sum / bins);
+    const double arithmetic = sum / bins;
+    return static_cast<float>(geometric / arithmetic);
+}